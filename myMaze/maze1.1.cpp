@@ -6,6 +6,41 @@
 #include <string>
 #include <algorithm> // Required for std::max
 //#include <utility> // For std::pair
+#include <random>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <stdexcept>
+
+// Memory-mapped files and sockets (kept lean so windows.h does not clash with raylib names)
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOUSER
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -39,47 +74,537 @@ const vector<Vector2i> directions = {
 
 
 // Function to shuffle directions randomly
-void ShuffleDirections(vector<Vector2i>& dirs) {
+void ShuffleDirections(vector<Vector2i>& dirs, mt19937& rng) {
     for (int i = dirs.size() - 1; i > 0; --i) {
-        int j = rand() % (i + 1);
+        int j = rng() % (i + 1);
         swap(dirs[i], dirs[j]);
     }
 }
 
-// Function to generate a random maze
-vector<vector<int>> GenerateMaze() {
-    vector<vector<int>> maze(mazeHeight, vector<int>(mazeWidth, 1)); // Initialize with walls
+// Resumable maze generator: the recursive backtracker from the README, carved a
+// bounded number of steps per call so a level can be built across several frames
+class MazeGenerator {
+public:
+    vector<vector<int>> maze;
+
+    void Start(int width, int height, uint32_t seed) {
+        maze.assign(height, vector<int>(width, 1)); // Initialize with walls
+        rng.seed(seed);
+        cellStack = stack<Vector2i>();
+        current = { 1, 1 };
+        maze[current.y][current.x] = 0;
+        totalCells = max(1, ((width - 1) / 2) * ((height - 1) / 2));
+        carvedCells = 1;
+        done = false;
+    }
+
+    // Advance at most maxSteps carve/backtrack steps, returns true once the maze is complete
+    bool Step(int maxSteps) {
+        int width = maze[0].size();
+        int height = maze.size();
+        for (int i = 0; i < maxSteps && !done; i++) {
+            shuffledDirs = directions; // reuses the buffer, no allocation per step
+            ShuffleDirections(shuffledDirs, rng);
+            bool moved = false;
+
+            for (const auto& dir : shuffledDirs) {
+                Vector2i next = { current.x + dir.x * 2, current.y + dir.y * 2 };
+                if (next.x > 0 && next.x < width - 1 &&
+                    next.y > 0 && next.y < height - 1 &&
+                    maze[next.y][next.x] == 1) {
+                    maze[current.y + dir.y][current.x + dir.x] = 0; // Remove wall
+                    maze[next.y][next.x] = 0; // Mark cell as visited
+                    cellStack.push(current);
+                    current = next;
+                    carvedCells++;
+                    moved = true;
+                    break;
+                }
+            }
+
+            if (!moved) {
+                if (cellStack.empty()) {
+                    done = true;
+                    break;
+                }
+                current = cellStack.top();
+                cellStack.pop();
+            }
+        }
+        return done;
+    }
+
+    // Carve until the time budget (in seconds) is spent, checking the clock every few steps
+    bool Run(double budgetSeconds, int stepsPerCheck = 64) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(budgetSeconds);
+        while (!Step(stepsPerCheck)) {
+            if (std::chrono::steady_clock::now() >= deadline) break;
+        }
+        return done;
+    }
+
+    bool Done() const { return done; }
+
+    // Fraction of maze cells carved so far (0..1)
+    float Progress() const {
+        return done ? 1.0f : static_cast<float>(carvedCells) / totalCells;
+    }
+
+private:
+    mt19937 rng;
     stack<Vector2i> cellStack;
+    vector<Vector2i> shuffledDirs;
     Vector2i current = { 1, 1 };
-    maze[current.y][current.x] = 0;
+    int totalCells = 1;
+    int carvedCells = 0;
+    bool done = true;
+};
+
+// Function to generate a random maze of any size from a seed, in one call
+vector<vector<int>> GenerateMaze(int width, int height, uint32_t seed) {
+    MazeGenerator generator;
+    generator.Start(width, height, seed);
+    generator.Step(INT_MAX);
+    return move(generator.maze);
+}
+
+uint32_t lastMazeSeed = 0; // Seed of the last maze generated for the game
+
+// Function to generate a random maze for the game (seeded from rand())
+vector<vector<int>> GenerateMaze() {
+    lastMazeSeed = rand();
+    return GenerateMaze(mazeWidth, mazeHeight, lastMazeSeed);
+}
+
+// Quality metrics used to vet generated levels
+struct MazeMetrics {
+    int solutionLength;    // steps from the start cell to the far corner (-1 if unreachable)
+    float deadEndRatio;    // open cells with a single exit / open cells
+    float branchingFactor; // open cells with three or more exits / open cells
+    int longestCorridor;   // longest straight run of open cells
+};
+
+// Function to measure a maze (BFS for the solution, one pass for the rest)
+MazeMetrics MeasureMaze(const vector<vector<int>>& maze) {
+    int height = maze.size();
+    int width = maze[0].size();
+    MazeMetrics metrics = { -1, 0.0f, 0.0f, 0 };
+
+    int openCells = 0;
+    int deadEnds = 0;
+    int junctions = 0;
+    for (int y = 0; y < height; y++) {
+        int run = 0;
+        for (int x = 0; x < width; x++) {
+            if (maze[y][x] != 0) {
+                run = 0;
+                continue;
+            }
+            run++;
+            metrics.longestCorridor = max(metrics.longestCorridor, run);
+
+            int exits = 0;
+            for (const auto& dir : directions) {
+                int nx = x + dir.x;
+                int ny = y + dir.y;
+                if (nx >= 0 && nx < width && ny >= 0 && ny < height && maze[ny][nx] == 0) exits++;
+            }
+            openCells++;
+            if (exits == 1) deadEnds++;
+            if (exits >= 3) junctions++;
+        }
+    }
+    for (int x = 0; x < width; x++) {
+        int run = 0;
+        for (int y = 0; y < height; y++) {
+            run = (maze[y][x] == 0) ? run + 1 : 0;
+            metrics.longestCorridor = max(metrics.longestCorridor, run);
+        }
+    }
+    if (openCells > 0) {
+        metrics.deadEndRatio = static_cast<float>(deadEnds) / openCells;
+        metrics.branchingFactor = static_cast<float>(junctions) / openCells;
+    }
+
+    // Cells are carved on odd coordinates, so the goal is the last odd cell in each axis
+    Vector2i goal = { (width - 2) | 1, (height - 2) | 1 };
+    if (goal.x >= width - 1) goal.x -= 2;
+    if (goal.y >= height - 1) goal.y -= 2;
+    if (goal.x < 1 || goal.y < 1 || maze[1][1] != 0) return metrics;
+
+    vector<int> distance(width * height, -1);
+    vector<int> queue;
+    queue.reserve(openCells);
+    distance[width + 1] = 0;
+    queue.push_back(width + 1);
+    for (size_t head = 0; head < queue.size(); head++) {
+        int cell = queue[head];
+        int x = cell % width;
+        int y = cell / width;
+        if (x == goal.x && y == goal.y) {
+            metrics.solutionLength = distance[cell];
+            break;
+        }
+        for (const auto& dir : directions) {
+            int nx = x + dir.x;
+            int ny = y + dir.y;
+            int next = ny * width + nx;
+            if (nx >= 0 && nx < width && ny >= 0 && ny < height &&
+                maze[ny][nx] == 0 && distance[next] < 0) {
+                distance[next] = distance[cell] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    return metrics;
+}
+
+
+// Maze generation algorithms recorded in maze files
+enum MazeAlgorithm {
+    RECURSIVE_BACKTRACKER = 0,
+    AUTHORED = 1
+};
+
+// Maze file layout (little endian):
+//   MazeFileHeader, then one MazeTileEntry per tile (row-major over tiles),
+//   then the tile payloads. Each tile covers tileSize x tileSize cells,
+//   bit-packed row-major (1 = wall, cells past the maze edge are walls) and
+//   compressed on its own, so a reader only has to decode the tiles it touches.
+struct MazeFileHeader {
+    char magic[4];        // "MZF1"
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t seed;
+    uint32_t algorithm;   // MazeAlgorithm
+    uint32_t tileSize;    // cells per tile edge, multiple of 8
+    uint32_t checksum;    // FNV-1a of the tile index, checked by MazeFileReader::Verify()
+    uint64_t indexOffset;
+};
+
+enum TileEncoding {
+    TILE_RAW = 0,
+    TILE_PACKBITS = 1
+};
+
+struct MazeTileEntry {
+    uint64_t offset;      // byte offset of the payload
+    uint32_t size;        // payload bytes
+    uint32_t checksum;    // FNV-1a of the decoded tile bits
+    uint32_t encoding;    // TileEncoding
+    uint32_t reserved;
+};
+
+uint32_t Fnv1a(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// PackBits run-length encoding: a control byte n < 128 is followed by n + 1
+// literal bytes, n > 128 repeats the next byte 257 - n times
+void PackBitsEncode(const vector<uint8_t>& in, vector<uint8_t>& out) {
+    size_t i = 0;
+    while (i < in.size()) {
+        size_t run = 1;
+        while (i + run < in.size() && run < 128 && in[i + run] == in[i]) run++;
+        if (run >= 2) {
+            out.push_back(static_cast<uint8_t>(257 - run));
+            out.push_back(in[i]);
+            i += run;
+            continue;
+        }
+        size_t literal = 1;
+        while (i + literal < in.size() && literal < 128 &&
+            !(i + literal + 1 < in.size() && in[i + literal] == in[i + literal + 1])) {
+            literal++;
+        }
+        out.push_back(static_cast<uint8_t>(literal - 1));
+        out.insert(out.end(), in.begin() + i, in.begin() + i + literal);
+        i += literal;
+    }
+}
+
+bool PackBitsDecode(const uint8_t* in, size_t size, vector<uint8_t>& out, size_t expected) {
+    out.clear();
+    size_t i = 0;
+    while (i < size) {
+        uint8_t control = in[i++];
+        if (control < 128) {
+            size_t literal = control + 1;
+            if (i + literal > size || out.size() + literal > expected) return false;
+            out.insert(out.end(), in + i, in + i + literal);
+            i += literal;
+        }
+        else if (control > 128) {
+            size_t run = 257 - control;
+            if (i >= size || out.size() + run > expected) return false;
+            out.insert(out.end(), run, in[i++]);
+        }
+    }
+    return out.size() == expected;
+}
+
+const uint32_t maxTileSize = 1024; // cells per tile edge
+
+// Function to write a maze file, returns false on bad arguments or I/O failure
+bool SaveMazeFile(const vector<vector<int>>& maze, uint32_t seed, MazeAlgorithm algorithm,
+    const std::string& filename, int tileSize = 32) {
+    if (tileSize <= 0 || tileSize % 8 != 0 || tileSize > static_cast<int>(maxTileSize)) {
+        std::cerr << "Maze tile size must be a multiple of 8 up to " << maxTileSize << ".\n";
+        return false;
+    }
+    int height = maze.size();
+    int width = maze[0].size();
+    int tilesX = (width + tileSize - 1) / tileSize;
+    int tilesY = (height + tileSize - 1) / tileSize;
+    size_t tileBytes = tileSize * tileSize / 8;
+
+    MazeFileHeader header = { { 'M', 'Z', 'F', '1' }, 1, static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+        seed, static_cast<uint32_t>(algorithm), static_cast<uint32_t>(tileSize), 0, sizeof(MazeFileHeader) };
+    vector<MazeTileEntry> index(tilesX * tilesY);
+    vector<uint8_t> payload;
+    vector<uint8_t> bits;
+    vector<uint8_t> packed;
+    uint64_t offset = header.indexOffset + index.size() * sizeof(MazeTileEntry);
+
+    for (int ty = 0; ty < tilesY; ty++) {
+        for (int tx = 0; tx < tilesX; tx++) {
+            bits.assign(tileBytes, 0);
+            for (int y = 0; y < tileSize; y++) {
+                for (int x = 0; x < tileSize; x++) {
+                    int mx = tx * tileSize + x;
+                    int my = ty * tileSize + y;
+                    bool wall = mx >= width || my >= height || maze[my][mx] != 0;
+                    int bit = y * tileSize + x;
+                    if (wall) bits[bit / 8] |= 1 << (bit % 8);
+                }
+            }
+            packed.clear();
+            PackBitsEncode(bits, packed);
+
+            MazeTileEntry& entry = index[ty * tilesX + tx];
+            entry.checksum = Fnv1a(bits.data(), bits.size());
+            entry.offset = offset + payload.size();
+            entry.reserved = 0;
+            if (packed.size() < bits.size()) {
+                entry.encoding = TILE_PACKBITS;
+                entry.size = packed.size();
+                payload.insert(payload.end(), packed.begin(), packed.end());
+            }
+            else {
+                entry.encoding = TILE_RAW;
+                entry.size = bits.size();
+                payload.insert(payload.end(), bits.begin(), bits.end());
+            }
+        }
+    }
+    header.checksum = Fnv1a(reinterpret_cast<const uint8_t*>(index.data()), index.size() * sizeof(MazeTileEntry));
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open " << filename << " for writing.\n";
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(MazeTileEntry));
+    file.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    file.close();
+    return static_cast<bool>(file);
+}
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { Close(); }
+
+    bool Open(const std::string& filename) {
+        Close();
+#if defined(_WIN32)
+        fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+            Close();
+            return false;
+        }
+        mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            Close();
+            return false;
+        }
+        data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            close(fd);
+            return false;
+        }
+        void* view = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED) return false;
+        data = static_cast<const uint8_t*>(view);
+        size = static_cast<size_t>(info.st_size);
+#endif
+        if (data == nullptr) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Close() {
+#if defined(_WIN32)
+        if (data != nullptr) UnmapViewOfFile(data);
+        if (mapping != nullptr) CloseHandle(mapping);
+        if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+        mapping = nullptr;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (data != nullptr) munmap(const_cast<uint8_t*>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    const uint8_t* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#if defined(_WIN32)
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+};
+
+// Random-access maze file reader: maps the file and decodes tiles on first use.
+// Opening only reads the header; the index and tiles are touched as cells are read.
+class MazeFileReader {
+public:
+    MazeFileHeader header = {};
+
+    bool Open(const std::string& filename) {
+        tiles.clear();
+        if (!file.Open(filename)) return false;
+        name = filename;
+        if (file.Size() < sizeof(MazeFileHeader)) return Fail(filename, "file too small");
+
+        memcpy(&header, file.Data(), sizeof(header));
+        if (memcmp(header.magic, "MZF1", 4) != 0 || header.version != 1) return Fail(filename, "not a maze file");
+        if (header.width == 0 || header.height == 0 || header.width > INT_MAX || header.height > INT_MAX ||
+            header.tileSize == 0 || header.tileSize % 8 != 0 || header.tileSize > maxTileSize) {
+            return Fail(filename, "bad dimensions");
+        }
+
+        tilesX = (header.width + header.tileSize - 1) / header.tileSize;
+        tilesY = (header.height + header.tileSize - 1) / header.tileSize;
+        indexBytes = static_cast<uint64_t>(tilesX) * tilesY * sizeof(MazeTileEntry);
+        if (header.indexOffset > file.Size() || indexBytes > file.Size() - header.indexOffset) {
+            return Fail(filename, "truncated tile index");
+        }
+        return true;
+    }
+
+    // Check the whole tile index against the header checksum (reads every index entry)
+    bool Verify() {
+        const uint8_t* index = file.Data() + header.indexOffset;
+        if (Fnv1a(index, indexBytes) != header.checksum) return Fail(name, "checksum mismatch");
+        return true;
+    }
 
-    while (!cellStack.empty() || current.x > 0 || current.y > 0) {
-        vector<Vector2i> shuffledDirs = directions;
-        ShuffleDirections(shuffledDirs);
-        bool moved = false;
+    int Width() const { return header.width; }
+    int Height() const { return header.height; }
+
+    // Returns 1 for a wall, 0 for a path; cells outside the maze are walls
+    int Cell(int x, int y) {
+        if (x < 0 || y < 0 || x >= Width() || y >= Height()) return 1;
+        int tileSize = header.tileSize;
+        const vector<uint8_t>* bits = Tile(x / tileSize, y / tileSize);
+        if (bits == nullptr) return 1;
+        int bit = (y % tileSize) * tileSize + (x % tileSize);
+        return ((*bits)[bit / 8] >> (bit % 8)) & 1;
+    }
 
-        for (const auto& dir : shuffledDirs) {
-            Vector2i next = { current.x + dir.x * 2, current.y + dir.y * 2 };
-            if (next.x > 0 && next.x < mazeWidth - 1 &&
-                next.y > 0 && next.y < mazeHeight - 1 &&
-                maze[next.y][next.x] == 1) {
-                maze[current.y + dir.y][current.x + dir.x] = 0; // Remove wall
-                maze[next.y][next.x] = 0; // Mark cell as visited
-                cellStack.push(current);
-                current = next;
-                moved = true;
-                break;
+    // Decode a rectangular region (e.g. the viewport); only overlapping tiles are touched
+    vector<vector<int>> ReadRegion(int x0, int y0, int width, int height) {
+        vector<vector<int>> region(height, vector<int>(width, 1));
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                region[y][x] = Cell(x0 + x, y0 + y);
             }
         }
+        return region;
+    }
+
+    vector<vector<int>> ReadAll() {
+        return ReadRegion(0, 0, Width(), Height());
+    }
+
+private:
+    MappedFile file;
+    std::string name;
+    uint64_t indexBytes = 0;
+    int tilesX = 0;
+    int tilesY = 0;
+    unordered_map<size_t, vector<uint8_t>> tiles; // decoded tiles by index, empty = corrupt (read as walls)
+
+    bool Fail(const std::string& filename, const char* reason) {
+        std::cerr << "Invalid maze file " << filename << ": " << reason << "\n";
+        file.Close();
+        return false;
+    }
+
+    const vector<uint8_t>* Tile(int tx, int ty) {
+        size_t tileIndex = static_cast<size_t>(ty) * tilesX + tx;
+        auto cached = tiles.find(tileIndex);
+        if (cached != tiles.end()) return cached->second.empty() ? nullptr : &cached->second;
+        vector<uint8_t>& bits = tiles[tileIndex];
+
+        // Copied out rather than cast: indexOffset comes from the file and may be misaligned
+        MazeTileEntry entry;
+        memcpy(&entry, file.Data() + header.indexOffset + tileIndex * sizeof(MazeTileEntry), sizeof(entry));
+        size_t tileBytes = header.tileSize * header.tileSize / 8;
+        if (entry.offset > file.Size() || entry.size > file.Size() - entry.offset) {
+            std::cerr << "Corrupt maze tile " << tx << "," << ty << "\n";
+            return nullptr;
+        }
+        const uint8_t* payload = file.Data() + entry.offset;
 
-        if (!moved) {
-            if (cellStack.empty()) break;
-            current = cellStack.top();
-            cellStack.pop();
+        bool ok;
+        if (entry.encoding == TILE_RAW) {
+            ok = entry.size == tileBytes;
+            if (ok) bits.assign(payload, payload + tileBytes);
         }
+        else {
+            ok = entry.encoding == TILE_PACKBITS && PackBitsDecode(payload, entry.size, bits, tileBytes);
+        }
+        if (!ok || Fnv1a(bits.data(), bits.size()) != entry.checksum) {
+            std::cerr << "Corrupt maze tile " << tx << "," << ty << "\n";
+            bits.clear();
+            return nullptr;
+        }
+        return &bits;
     }
+};
 
-    return maze;
+// Function to load a whole maze from a maze file, optionally returning its header (seed, algorithm)
+bool LoadMazeFile(const std::string& filename, vector<vector<int>>& maze, MazeFileHeader* header = nullptr) {
+    MazeFileReader reader;
+    if (!reader.Open(filename) || !reader.Verify()) return false;
+    maze = reader.ReadAll();
+    if (header != nullptr) *header = reader.header;
+    return true;
 }
 
 
@@ -151,222 +676,1806 @@ public:
         image = texture;
         position = { 1.0f, 1.0f };  // Starting position (aligned with the grid)
     }
-
-    void Draw(Vector2 offset) {
-        DrawTextureV(image, { offset.x + position.x * gridSize, offset.y + position.y * gridSize }, WHITE);
+
+    void Draw(Vector2 offset) {
+        DrawTextureV(image, { offset.x + position.x * gridSize, offset.y + position.y * gridSize }, WHITE);
+    }
+
+    void Move(Vector2 direction, const vector<vector<int>>& maze) {
+        Vector2 nextPosition = { position.x + direction.x, position.y + direction.y };
+
+        // Check if the next position is a valid path (not a wall)
+        if (nextPosition.x >= 0 && nextPosition.x < maze[0].size() &&
+            nextPosition.y >= 0 && nextPosition.y < maze.size() &&
+            maze[static_cast<int>(nextPosition.y)][static_cast<int>(nextPosition.x)] == 0) {
+            position = nextPosition;
+        }
+    }
+};
+
+
+// Enemy patrol movement, free of rendering so hosted sessions can run it headless
+struct EnemyPatrol {
+    Vector2i position;
+    vector<Vector2i> patrolPath;
+    int patrolIndex = 0;
+    float moveTimer = 0.0f; // Timer for movement
+    float moveDelay = 0.5f; // Delay between movements in seconds
+
+    EnemyPatrol(const vector<Vector2i>& path) {
+        patrolPath = path;
+        position = patrolPath[0];
+    }
+
+    void Update(float deltaTime) {
+        moveTimer += deltaTime;
+        if (moveTimer >= moveDelay) {
+            patrolIndex = (patrolIndex + 1) % patrolPath.size();
+            position = patrolPath[patrolIndex];
+            moveTimer = 0.0f; // Reset timer
+        }
+    }
+};
+
+// Enemy class
+class Enemy : public EnemyPatrol {
+public:
+    Texture2D image;
+
+    Enemy(Texture2D& texture, const vector<Vector2i>& path) : EnemyPatrol(path) {
+        image = texture;
+    }
+
+    void Draw(Vector2 offset) const {
+        DrawTextureV(image, { offset.x + position.x * gridSize, offset.y + position.y * gridSize }, WHITE);
+    }
+};
+
+
+// food class
+class Food {
+public:
+    Vector2i position;
+    Texture2D texture;
+
+    // Food image
+    Food(Texture2D& texture, const vector<vector<int>>& maze) : texture(texture)
+    {
+        position = GenerateRandomPos(maze);
+    }
+
+    void Draw(Vector2 offset) {
+        DrawTexture(texture, offset.x + position.x * gridSize, offset.y + position.y * gridSize, WHITE);
+    }
+
+    // Generate random food position
+    Vector2i GenerateRandomPos(const vector<vector<int>>& maze)
+    {
+        Vector2i newPos;
+        do {
+            // Generate a random position within the maze's boundaries
+            newPos = { GetRandomValue(0, maze[0].size() - 1), GetRandomValue(0, maze.size() - 1) };
+        } while (maze[newPos.y][newPos.x] != 0);  // Ensure food spawns on a valid path
+        return newPos;
+    }
+};
+
+// Sounds
+Sound Foodsound;
+Sound GOsound;
+Sound Nextlevel;
+Sound powerupsd;
+Music backgsound;
+
+void InitSounds() {
+    InitAudioDevice();
+
+    Foodsound = LoadSound("sounds/foodsound.wav");
+    GOsound = LoadSound("sounds/gosound.wav");
+    Nextlevel = LoadSound("sounds/nextlevel.wav");
+    powerupsd = LoadSound("sounds/powerUpsound.wav");
+
+    backgsound = LoadMusicStream("sounds/backgroundsound.mp3");
+    PlayMusicStream(backgsound);
+}
+
+// One-shot sound event: plays when its condition becomes true and
+// re-arms once the condition is false again, however many frames it lasts
+struct AudioEvent {
+    bool fired = false;
+
+    void Update(bool active, Sound sound) {
+        if (active && !fired) PlaySound(sound);
+        fired = active;
+    }
+};
+
+// Function to solve the puzzle in-game
+bool SolvePuzzle(int& remainingAttempts) {
+    srand(static_cast<unsigned>(time(0)));
+    int a = rand() % 10 + 1;
+    int b = rand() % 10 + 1;
+    int correctAnswer = a + b;
+
+    std::string input = "";
+    bool solved = false;
+    bool running = true;
+
+    while (running) {
+        BeginDrawing();
+        ClearBackground(BLACK);
+
+        // Draw puzzle text
+        DrawText(("Solve: " + std::to_string(a) + " + " + std::to_string(b)).c_str(), 50, 50, 20, WHITE);
+        DrawText(("Your Answer: " + input).c_str(), 50, 100, 20, WHITE);
+        DrawText(("Attempts Left: " + std::to_string(remainingAttempts)).c_str(), 50, 150, 20, RED);
+
+        // Debugging output
+        TraceLog(LOG_INFO, "Attempts: %d, Input: %s, Solved: %d, Running: %d",
+            remainingAttempts, input.c_str(), solved, running);
+
+        // Handle keyboard input
+        if (IsKeyPressed(KEY_ENTER)) {
+            if (!input.empty() && std::all_of(input.begin(), input.end(), ::isdigit)) {
+                int playerAnswer = std::stoi(input);
+                if (playerAnswer == correctAnswer) {
+                    solved = true;
+                    running = false;
+                }
+                else {
+                    remainingAttempts--;
+                    if (remainingAttempts > 0) {
+                        input = "Try Again!";
+                    }
+                    else {
+                        running = false; // Out of attempts
+                    }
+                }
+            }
+            else {
+                input = "Invalid Input!";
+            }
+        }
+        else if (IsKeyPressed(KEY_BACKSPACE) && !input.empty()) {
+            input.pop_back();
+        }
+        else {
+            // Check for numeric input
+            for (int key = KEY_ZERO; key <= KEY_NINE; ++key) {
+                if (IsKeyPressed(key)) {
+                    input += (key - KEY_ZERO) + '0';
+                }
+            }
+        }
+
+        // Draw feedback if incorrect
+        if (!solved && input == "Try Again!") {
+            DrawText("Incorrect. Try again!", 50, 200, 20, RED);
+        }
+        else if (!solved && input == "Invalid Input!") {
+            DrawText("Please enter a valid number!", 50, 200, 20, RED);
+        }
+
+        EndDrawing();
+
+        // Exit if no attempts left
+        if (remainingAttempts <= 0) {
+            break;
+        }
+    }
+
+    TraceLog(LOG_INFO, "Final Solved: %d, Remaining Attempts: %d", solved, remainingAttempts);
+    return solved;
+}
+
+// Exit Struct
+class Exit {
+public:
+    Vector2 position; // Grid position (floating-point for flexibility)
+    bool active;
+
+    Exit() : position({ -1.0f, -1.0f }), active(false) {}
+
+    void Activate(const vector<vector<int>>& maze) {
+        position = GenerateRandomPos(maze);
+        active = true;
+    }
+
+    void Deactivate() {
+        position = { -1.0f, -1.0f }; // Move to an invalid position
+        active = false;
+    }
+
+    void Draw(Vector2 offset) {
+        if (active) {
+            DrawRectangleV({ offset.x + position.x * gridSize, offset.y + position.y * gridSize },
+                { gridSize, gridSize }, GREEN);
+        }
+    }
+
+private:
+    Vector2 GenerateRandomPos(const vector<vector<int>>& maze) {
+        Vector2 newPos;
+        do {
+            newPos = { static_cast<float>(GetRandomValue(0, maze[0].size() - 1)),
+                       static_cast<float>(GetRandomValue(0, maze.size() - 1)) };
+        } while (maze[static_cast<int>(newPos.y)][static_cast<int>(newPos.x)] != 0); // Ensure it's on a valid path
+        return newPos;
+    }
+};
+
+
+
+// Function to draw the maze walls
+void DrawMaze(const vector<vector<int>>& maze, Vector2 offset) {
+    int height = maze.size();
+    int width = maze[0].size();
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (maze[y][x] == 1) {
+                DrawRectangle(offset.x + x * gridSize, offset.y + y * gridSize, gridSize, gridSize, BLACK);
+                //DrawRectangleLines(offset.x + x * gridSize, offset.y + y * gridSize, gridSize, gridSize, WHITE);
+                DrawRectangleLinesEx({ offset.x + x * gridSize, offset.y + y * gridSize, gridSize, gridSize }, 2, RED);
+            }
+        }
+    }
+}
+
+// Bit-per-cell set over the maze grid, row-major, 64 cells per word
+class GridBitset {
+public:
+    void Reset(int newWidth, int newHeight) {
+        width = newWidth;
+        height = newHeight;
+        words.assign((static_cast<size_t>(width) * height + 63) / 64, 0);
+    }
+
+    bool Test(int x, int y) const {
+        size_t bit = static_cast<size_t>(y) * width + x;
+        return (words[bit / 64] >> (bit % 64)) & 1;
+    }
+    void Set(int x, int y) {
+        size_t bit = static_cast<size_t>(y) * width + x;
+        words[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+    void Clear(int x, int y) {
+        size_t bit = static_cast<size_t>(y) * width + x;
+        words[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+    }
+    bool Contains(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height; }
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+private:
+    int width = 0;
+    int height = 0;
+    vector<uint64_t> words;
+};
+
+// Fog of war and line of sight over a maze. The visible set is recomputed by
+// recursive shadowcasting within the sight radius whenever the viewer moves;
+// only the square around the old and new position is touched, never the whole map.
+class Visibility {
+public:
+    GridBitset walls;    // copy of the maze walls for fast lookups
+    GridBitset visible;  // cells the viewer sees right now
+    GridBitset explored; // cells the viewer has ever seen
+
+    void Reset(const vector<vector<int>>& maze, int sightRadius) {
+        int height = maze.size();
+        int width = maze[0].size();
+        radius = sightRadius;
+        walls.Reset(width, height);
+        visible.Reset(width, height);
+        explored.Reset(width, height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                if (maze[y][x] != 0) walls.Set(x, y);
+            }
+        }
+        viewer = { -1, -1 };
+    }
+
+    // Recompute what is visible from a new viewer position (no-op if it has not moved)
+    void Update(Vector2i position) {
+        if (position.x == viewer.x && position.y == viewer.y) return;
+        if (viewer.x >= 0) {
+            for (int y = viewer.y - radius; y <= viewer.y + radius; y++) {
+                for (int x = viewer.x - radius; x <= viewer.x + radius; x++) {
+                    if (visible.Contains(x, y)) visible.Clear(x, y);
+                }
+            }
+        }
+        viewer = position;
+        if (!visible.Contains(viewer.x, viewer.y)) return;
+
+        Reveal(viewer.x, viewer.y);
+        // Octant transforms for the shadowcaster: (xx, xy, yx, yy)
+        static const int octants[8][4] = {
+            { 1, 0, 0, 1 }, { 0, 1, 1, 0 }, { 0, -1, 1, 0 }, { -1, 0, 0, 1 },
+            { -1, 0, 0, -1 }, { 0, -1, -1, 0 }, { 0, 1, -1, 0 }, { 1, 0, 0, -1 }
+        };
+        for (const auto& octant : octants) {
+            CastLight(1, 1.0f, 0.0f, octant[0], octant[1], octant[2], octant[3]);
+        }
+    }
+
+    // Bresenham walk over the wall bitset; walls block sight, the end cells do not
+    bool HasLineOfSight(Vector2i from, Vector2i to, int maxDistance) const {
+        int dx = abs(to.x - from.x);
+        int dy = abs(to.y - from.y);
+        if (dx * dx + dy * dy > maxDistance * maxDistance) return false;
+        int stepX = from.x < to.x ? 1 : -1;
+        int stepY = from.y < to.y ? 1 : -1;
+        int error = dx - dy;
+        Vector2i cell = from;
+        while (cell.x != to.x || cell.y != to.y) {
+            int doubled = 2 * error;
+            if (doubled > -dy) {
+                error -= dy;
+                cell.x += stepX;
+            }
+            if (doubled < dx) {
+                error += dx;
+                cell.y += stepY;
+            }
+            if ((cell.x != to.x || cell.y != to.y) &&
+                (!walls.Contains(cell.x, cell.y) || walls.Test(cell.x, cell.y))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    int radius = 5;
+    Vector2i viewer = { -1, -1 };
+
+    bool Blocks(int x, int y) const { return !walls.Contains(x, y) || walls.Test(x, y); }
+
+    void Reveal(int x, int y) {
+        visible.Set(x, y);
+        explored.Set(x, y);
+    }
+
+    // Scan one octant row by row, recursing around walls to narrow the lit slope range
+    void CastLight(int row, float startSlope, float endSlope, int xx, int xy, int yx, int yy) {
+        if (startSlope < endSlope) return;
+        float nextStart = startSlope;
+        for (int distance = row; distance <= radius; distance++) {
+            bool blocked = false;
+            for (int dx = -distance, dy = -distance; dx <= 0; dx++) {
+                float leftSlope = (dx - 0.5f) / (dy + 0.5f);
+                float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+                if (startSlope < rightSlope) continue;
+                if (endSlope > leftSlope) break;
+
+                int x = viewer.x + dx * xx + dy * xy;
+                int y = viewer.y + dx * yx + dy * yy;
+                if (visible.Contains(x, y) && dx * dx + dy * dy <= radius * radius) Reveal(x, y);
+
+                if (blocked) {
+                    if (Blocks(x, y)) {
+                        nextStart = rightSlope;
+                    }
+                    else {
+                        blocked = false;
+                        startSlope = nextStart;
+                    }
+                }
+                else if (Blocks(x, y) && distance < radius) {
+                    blocked = true;
+                    CastLight(distance + 1, startSlope, leftSlope, xx, xy, yx, yy);
+                    nextStart = rightSlope;
+                }
+            }
+            if (blocked) break;
+        }
+    }
+};
+
+const int sightRadius = 5; // cells the player can see
+
+// Function to draw fog over cells never seen and dim those not currently visible
+void DrawFog(const Visibility& fog, Vector2 offset) {
+    for (int y = 0; y < fog.explored.Height(); y++) {
+        for (int x = 0; x < fog.explored.Width(); x++) {
+            if (!fog.explored.Test(x, y)) {
+                DrawRectangle(offset.x + x * gridSize, offset.y + y * gridSize, gridSize, gridSize, BLACK);
+            }
+            else if (!fog.visible.Test(x, y)) {
+                DrawRectangle(offset.x + x * gridSize, offset.y + y * gridSize, gridSize, gridSize, Fade(BLACK, 0.6f));
+            }
+        }
+    }
+}
+
+// Work-stealing thread pool: every worker owns a deque and steals the oldest task
+// from another worker when it runs dry. Tasks a worker spawns itself run newest-first,
+// tasks submitted from outside the pool run oldest-first so they finish in order
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threadCount) {
+        if (threadCount == 0) threadCount = 1;
+        for (unsigned i = 0; i < threadCount; i++) {
+            queues.emplace_back(new WorkerQueue());
+        }
+        for (unsigned i = 0; i < threadCount; i++) {
+            workers.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+        }
+    }
+
+    ~WorkStealingPool() {
+        WaitIdle();
+        {
+            lock_guard<mutex> lock(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    unsigned Size() const { return workers.size(); }
+
+    // Tasks submitted from a worker go to its own deque, others are spread round-robin
+    void Submit(function<void()> task) {
+        bool spawned = (currentPool == this);
+        size_t index = spawned ? workerIndex : nextQueue++ % queues.size();
+        pending++;
+        {
+            lock_guard<mutex> lock(queues[index]->lock);
+            queues[index]->tasks.push_back({ move(task), spawned });
+        }
+        {
+            lock_guard<mutex> lock(sleepLock);
+            queued++;
+        }
+        wake.notify_one();
+    }
+
+    // Block until every submitted task has finished
+    void WaitIdle() {
+        unique_lock<mutex> lock(sleepLock);
+        idle.wait(lock, [this] { return pending == 0; });
+    }
+
+private:
+    struct PoolTask {
+        function<void()> run;
+        bool spawned;
+    };
+
+    struct WorkerQueue {
+        mutex lock;
+        deque<PoolTask> tasks;
+    };
+
+    vector<unique_ptr<WorkerQueue>> queues;
+    vector<thread> workers;
+    mutex sleepLock;
+    condition_variable wake;
+    condition_variable idle;
+    atomic<long> queued{ 0 };
+    atomic<long> pending{ 0 };
+    atomic<size_t> nextQueue{ 0 };
+    bool stopping = false;
+
+    static thread_local WorkStealingPool* currentPool;
+    static thread_local size_t workerIndex;
+
+    bool TryPop(size_t index, function<void()>& task) {
+        for (size_t i = 0; i < queues.size(); i++) {
+            WorkerQueue& queue = *queues[(index + i) % queues.size()];
+            lock_guard<mutex> lock(queue.lock);
+            if (queue.tasks.empty()) continue;
+            if (i == 0 && queue.tasks.back().spawned) {
+                task = move(queue.tasks.back().run);
+                queue.tasks.pop_back();
+            }
+            else {
+                task = move(queue.tasks.front().run);
+                queue.tasks.pop_front();
+            }
+            queued--;
+            return true;
+        }
+        return false;
+    }
+
+    void WorkerLoop(size_t index) {
+        currentPool = this;
+        workerIndex = index;
+        function<void()> task;
+        while (true) {
+            if (TryPop(index, task)) {
+                task();
+                task = nullptr;
+                if (--pending == 0) {
+                    lock_guard<mutex> lock(sleepLock);
+                    idle.notify_all();
+                }
+                continue;
+            }
+            unique_lock<mutex> lock(sleepLock);
+            wake.wait(lock, [this] { return stopping || queued > 0; });
+            if (stopping && queued <= 0) return;
+        }
+    }
+};
+
+thread_local WorkStealingPool* WorkStealingPool::currentPool = nullptr;
+thread_local size_t WorkStealingPool::workerIndex = 0;
+
+const int maxPoolThreads = 256; // upper bound accepted for --threads
+
+// Validate a --threads value before it reaches the pool
+bool ParseThreadCount(const char* value, unsigned& threads) {
+    int count = std::stoi(value);
+    if (count <= 0 || count > maxPoolThreads) {
+        std::cerr << "--threads must be between 1 and " << maxPoolThreads << ".\n";
+        return false;
+    }
+    threads = count;
+    return true;
+}
+
+
+// Thresholds a generated maze has to meet to be kept in the level corpus
+struct MazeFilter {
+    int minSolutionLength = 0;
+    int maxLongestCorridor = INT_MAX;
+    float maxDeadEndRatio = 1.0f;
+    float minBranchingFactor = 0.0f;
+};
+
+bool PassesFilter(const MazeMetrics& metrics, const MazeFilter& filter) {
+    return metrics.solutionLength >= filter.minSolutionLength &&
+        metrics.longestCorridor <= filter.maxLongestCorridor &&
+        metrics.deadEndRatio <= filter.maxDeadEndRatio &&
+        metrics.branchingFactor >= filter.minBranchingFactor;
+}
+
+// Level corpus file layout (little endian):
+//   CorpusHeader, then one bit-packed maze per kept level (row-major, 1 = wall),
+//   then one CorpusIndexEntry per kept level starting at header.indexOffset
+struct CorpusHeader {
+    char magic[4];        // "MZC1"
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint64_t count;       // number of kept levels
+    uint64_t indexOffset; // byte offset of the index table
+};
+
+struct CorpusIndexEntry {
+    uint32_t seed;
+    int32_t solutionLength;
+    float deadEndRatio;
+    float branchingFactor;
+    int32_t longestCorridor;
+    uint32_t reserved;
+    uint64_t offset;      // byte offset of the packed maze
+};
+
+// Function to bit-pack a maze, row-major, one bit per cell
+void PackMaze(const vector<vector<int>>& maze, vector<uint8_t>& out) {
+    int height = maze.size();
+    int width = maze[0].size();
+    size_t start = out.size();
+    out.resize(start + (static_cast<size_t>(width) * height + 7) / 8, 0);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            size_t bit = static_cast<size_t>(y) * width + x;
+            if (maze[y][x] != 0) out[start + bit / 8] |= 1 << (bit % 8);
+        }
+    }
+}
+
+// Batch generation settings (see PrintBatchUsage)
+const int maxBatchDimension = 4096; // upper bound accepted for --width and --height
+
+struct BatchSettings {
+    uint64_t count = 1000000;
+    uint32_t firstSeed = 1;
+    int width = mazeWidth;
+    int height = mazeHeight;
+    unsigned threads = thread::hardware_concurrency();
+    std::string outputFile = "levels.mzc";
+    MazeFilter filter;
+};
+
+// One unit of batch work: a contiguous range of seeds and the levels it kept
+struct BatchChunk {
+    vector<CorpusIndexEntry> entries;
+    vector<uint8_t> packed;
+    bool done = false;
+};
+
+void PrintBatchUsage() {
+    std::cerr << "Usage: myMaze --batch [options]\n"
+        << "  --count N            mazes to generate (default 1000000)\n"
+        << "  --seed N             first seed, mazes use seed, seed+1, ... (default 1)\n"
+        << "  --width N            maze columns, 3.." << maxBatchDimension << " (default " << mazeWidth << ")\n"
+        << "  --height N           maze rows, 3.." << maxBatchDimension << " (default " << mazeHeight << ")\n"
+        << "  --threads N          worker threads (default: all cores)\n"
+        << "  --out FILE           output corpus (default levels.mzc)\n"
+        << "  --min-solution N     minimum solution length\n"
+        << "  --max-corridor N     maximum straight corridor length\n"
+        << "  --max-dead-ends F    maximum dead-end ratio (0..1)\n"
+        << "  --min-branching F    minimum branching factor (0..1)\n";
+}
+
+bool ParseBatchSettings(int argc, char* argv[], BatchSettings& settings) {
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help") return false;
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        try {
+            if (arg == "--count") settings.count = std::stoull(value);
+            else if (arg == "--seed") {
+                unsigned long long seed = std::stoull(value);
+                if (seed > UINT32_MAX) throw std::out_of_range("seed");
+                settings.firstSeed = static_cast<uint32_t>(seed);
+            }
+            else if (arg == "--width") settings.width = std::stoi(value);
+            else if (arg == "--height") settings.height = std::stoi(value);
+            else if (arg == "--threads") {
+                if (!ParseThreadCount(value, settings.threads)) return false;
+            }
+            else if (arg == "--out") settings.outputFile = value;
+            else if (arg == "--min-solution") settings.filter.minSolutionLength = std::stoi(value);
+            else if (arg == "--max-corridor") settings.filter.maxLongestCorridor = std::stoi(value);
+            else if (arg == "--max-dead-ends") settings.filter.maxDeadEndRatio = std::stof(value);
+            else if (arg == "--min-branching") settings.filter.minBranchingFactor = std::stof(value);
+            else {
+                std::cerr << "Unknown option " << arg << "\n";
+                return false;
+            }
+        }
+        catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+            return false;
+        }
+    }
+    if (settings.width < 3 || settings.height < 3) {
+        std::cerr << "Maze must be at least 3x3.\n";
+        return false;
+    }
+    if (settings.width > maxBatchDimension || settings.height > maxBatchDimension) {
+        std::cerr << "Maze must be at most " << maxBatchDimension << "x" << maxBatchDimension << ".\n";
+        return false;
+    }
+    // Seeds are 32-bit; running past the last one would repeat levels
+    uint64_t seedsLeft = static_cast<uint64_t>(UINT32_MAX) - settings.firstSeed + 1;
+    if (settings.count > seedsLeft) {
+        std::cerr << "--count " << settings.count << " would run past the last seed; at most "
+            << seedsLeft << " mazes fit after seed " << settings.firstSeed << ".\n";
+        return false;
+    }
+    return true;
+}
+
+// Batch mode: generate, measure and filter seeded mazes on all cores and
+// write the survivors to an indexed level corpus. Runs without a window.
+int RunBatch(int argc, char* argv[]) {
+    BatchSettings settings;
+    if (!ParseBatchSettings(argc, argv, settings)) {
+        PrintBatchUsage();
+        return 1;
+    }
+
+    std::ofstream file(settings.outputFile, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open " << settings.outputFile << " for writing.\n";
+        return 1;
+    }
+
+    CorpusHeader header = { { 'M', 'Z', 'C', '1' }, 1,
+        static_cast<uint32_t>(settings.width), static_cast<uint32_t>(settings.height), 0, 0 };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const uint64_t chunkSize = 4096;
+    const uint64_t chunkCount = (settings.count + chunkSize - 1) / chunkSize;
+    const size_t packedSize = (static_cast<size_t>(settings.width) * settings.height + 7) / 8;
+    mutex doneLock;
+    condition_variable chunkDone;
+    atomic<uint64_t> generated{ 0 };
+    atomic<uint64_t> kept{ 0 };
+
+    auto start = std::chrono::steady_clock::now();
+    WorkStealingPool pool(settings.threads);
+    std::cout << "Generating " << settings.count << " mazes (" << settings.width << "x" << settings.height
+        << ") on " << pool.Size() << " threads...\n";
+
+    // Only a few chunks per worker are in flight at once; each slot is reused
+    // for the chunk `window` places later once the writer has drained it
+    const uint64_t window = min<uint64_t>(chunkCount, pool.Size() * 4);
+    vector<BatchChunk> chunks(window);
+    auto submitChunk = [&](uint64_t c) {
+        pool.Submit([&, c] {
+            BatchChunk& chunk = chunks[c % window];
+            uint64_t first = c * chunkSize;
+            uint64_t last = min(settings.count, first + chunkSize);
+            for (uint64_t i = first; i < last; i++) {
+                uint32_t seed = settings.firstSeed + static_cast<uint32_t>(i);
+                vector<vector<int>> maze = GenerateMaze(settings.width, settings.height, seed);
+                MazeMetrics metrics = MeasureMaze(maze);
+                if (!PassesFilter(metrics, settings.filter)) continue;
+
+                CorpusIndexEntry entry = { seed, metrics.solutionLength, metrics.deadEndRatio,
+                    metrics.branchingFactor, metrics.longestCorridor, 0, 0 };
+                chunk.entries.push_back(entry);
+                PackMaze(maze, chunk.packed);
+            }
+            generated += last - first;
+            kept += chunk.entries.size();
+            {
+                lock_guard<mutex> lock(doneLock);
+                chunk.done = true;
+            }
+            chunkDone.notify_one();
+        });
+    };
+    for (uint64_t c = 0; c < window; c++) submitChunk(c);
+
+    // Write chunks in seed order as they complete so the corpus is deterministic,
+    // reporting progress from the workers' counters every couple of seconds
+    const auto reportInterval = std::chrono::seconds(2);
+    auto lastReport = start;
+    vector<CorpusIndexEntry> index;
+    uint64_t offset = sizeof(header);
+    for (uint64_t c = 0; c < chunkCount; c++) {
+        BatchChunk& chunk = chunks[c % window];
+        bool ready = false;
+        while (!ready) {
+            {
+                unique_lock<mutex> lock(doneLock);
+                ready = chunkDone.wait_for(lock, reportInterval, [&] { return chunk.done; });
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (now - lastReport >= reportInterval) {
+                std::cout << "  " << generated << " generated, " << kept << " kept\n";
+                lastReport = now;
+            }
+        }
+        for (auto& entry : chunk.entries) {
+            entry.offset = offset;
+            offset += packedSize;
+            index.push_back(entry);
+        }
+        file.write(reinterpret_cast<const char*>(chunk.packed.data()), chunk.packed.size());
+        chunk.entries.clear();
+        chunk.packed.clear();
+        chunk.done = false;
+        if (c + window < chunkCount) submitChunk(c + window);
+    }
+    pool.WaitIdle();
+
+    header.count = index.size();
+    header.indexOffset = offset;
+    file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(CorpusIndexEntry));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file) {
+        std::cerr << "Failed to write " << settings.outputFile << ".\n";
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Kept " << index.size() << " of " << settings.count << " mazes in " << seconds << "s ("
+        << static_cast<uint64_t>(settings.count / max(seconds, 1e-6)) << " mazes/s), written to "
+        << settings.outputFile << "\n";
+    return 0;
+}
+
+
+// Socket portability (Winsock on Windows, BSD sockets elsewhere)
+#if defined(_WIN32)
+typedef SOCKET SocketHandle;
+typedef WSAPOLLFD PollDescriptor;
+const int sendFlags = 0;
+bool InitNetwork() {
+    WSADATA wsaData;
+    return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+}
+void ShutdownNetwork() { WSACleanup(); }
+void CloseSocket(SocketHandle socket) { closesocket(socket); }
+bool SetNonBlocking(SocketHandle socket) {
+    u_long enabled = 1;
+    return ioctlsocket(socket, FIONBIO, &enabled) == 0;
+}
+bool SocketWouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+int PollSockets(PollDescriptor* descriptors, size_t count, int timeoutMs) {
+    return WSAPoll(descriptors, static_cast<ULONG>(count), timeoutMs);
+}
+#else
+typedef int SocketHandle;
+typedef pollfd PollDescriptor;
+const SocketHandle INVALID_SOCKET = -1;
+const int sendFlags = MSG_NOSIGNAL;
+bool InitNetwork() { return true; }
+void ShutdownNetwork() {}
+void CloseSocket(SocketHandle socket) { close(socket); }
+bool SetNonBlocking(SocketHandle socket) {
+    int flags = fcntl(socket, F_GETFL, 0);
+    return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+bool SocketWouldBlock() { return errno == EWOULDBLOCK || errno == EAGAIN; }
+int PollSockets(PollDescriptor* descriptors, size_t count, int timeoutMs) {
+    return poll(descriptors, count, timeoutMs);
+}
+#endif
+
+const int defaultServerPort = 47011;
+
+// Validate a --port value before it reaches htons
+bool ParsePort(const char* value, int& port) {
+    int number = std::stoi(value);
+    if (number < 1 || number > 65535) {
+        std::cerr << "--port must be between 1 and 65535.\n";
+        return false;
+    }
+    port = number;
+    return true;
+}
+
+// Session protocol over a local TCP socket. Every message is framed as
+// u32 length (of type + payload), u8 type, payload; integers are little endian.
+//   client -> server: MSG_JOIN u32 sessionId (NEW_SESSION for a fresh game)
+//                     MSG_INPUT u8 action (index into directions, or ACTION_RESTART)
+//   server -> client: MSG_WELCOME u32 sessionId
+//                     MSG_SNAPSHOT u32 tick, u16 field mask, then the changed fields
+enum MessageType {
+    MSG_JOIN = 1,
+    MSG_INPUT = 2,
+    MSG_WELCOME = 3,
+    MSG_SNAPSHOT = 4
+};
+
+const uint32_t NEW_SESSION = 0xFFFFFFFF;
+const uint8_t ACTION_RESTART = 4;
+const uint32_t maxMessageSize = 16 * 1024 * 1024;
+
+// Snapshot fields, sent in this order when their bit is set
+enum SnapshotField {
+    SNAP_MAZE = 1 << 0,    // u16 width, u16 height, bit-packed cells
+    SNAP_PLAYER = 1 << 1,  // u16 x, u16 y
+    SNAP_FOOD = 1 << 2,    // u16 x, u16 y
+    SNAP_EXIT = 1 << 3,    // u8 active, u16 x, u16 y
+    SNAP_SCORE = 1 << 4,   // i32
+    SNAP_LEVEL = 1 << 5,   // u16
+    SNAP_TIMER = 1 << 6,   // u16 tenths of a second
+    SNAP_ENEMIES = 1 << 7, // u8 count, u16 x, u16 y per enemy
+    SNAP_ALL = 0xFF
+};
+
+void PutU8(vector<uint8_t>& out, uint8_t value) { out.push_back(value); }
+void PutU16(vector<uint8_t>& out, uint16_t value) {
+    out.push_back(value & 0xFF);
+    out.push_back(value >> 8);
+}
+void PutU32(vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back((value >> (i * 8)) & 0xFF);
+}
+
+// Bounds-checked little-endian reader over a received message
+struct ByteReader {
+    const uint8_t* data;
+    size_t size;
+    size_t position = 0;
+    bool ok = true;
+
+    ByteReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    uint32_t Get(int bytes) {
+        if (position + bytes > size) {
+            ok = false;
+            return 0;
+        }
+        uint32_t value = 0;
+        for (int i = 0; i < bytes; i++) value |= static_cast<uint32_t>(data[position++]) << (i * 8);
+        return value;
+    }
+    uint8_t U8() { return Get(1); }
+    uint16_t U16() { return Get(2); }
+    uint32_t U32() { return Get(4); }
+};
+
+// Start a framed message, returns where the length has to be patched in
+size_t BeginMessage(vector<uint8_t>& out, MessageType type) {
+    size_t start = out.size();
+    PutU32(out, 0);
+    PutU8(out, type);
+    return start;
+}
+
+void EndMessage(vector<uint8_t>& out, size_t start) {
+    uint32_t length = out.size() - start - 4;
+    for (int i = 0; i < 4; i++) out[start + i] = (length >> (i * 8)) & 0xFF;
+}
+
+// Pop one complete message off a receive buffer, returns false if none is complete yet
+bool PopMessage(vector<uint8_t>& buffer, vector<uint8_t>& message, bool& protocolError) {
+    if (buffer.size() < 4) return false;
+    uint32_t length = buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | (static_cast<uint32_t>(buffer[3]) << 24);
+    if (length == 0 || length > maxMessageSize) {
+        protocolError = true;
+        return false;
+    }
+    if (buffer.size() < 4 + length) return false;
+    message.assign(buffer.begin() + 4, buffer.begin() + 4 + length);
+    buffer.erase(buffer.begin(), buffer.begin() + 4 + length);
+    return true;
+}
+
+// Send as much of a buffer as the non-blocking socket takes, keeping the rest for later.
+// Returns false if the connection failed.
+bool FlushOutgoing(SocketHandle socket, vector<uint8_t>& outgoing) {
+    size_t sent = 0;
+    bool ok = true;
+    while (sent < outgoing.size()) {
+        int count = send(socket, reinterpret_cast<const char*>(outgoing.data() + sent),
+            static_cast<int>(outgoing.size() - sent), sendFlags);
+        if (count > 0) {
+            sent += count;
+            continue;
+        }
+        if (count < 0 && !SocketWouldBlock()) ok = false;
+        break;
+    }
+    outgoing.erase(outgoing.begin(), outgoing.begin() + sent);
+    return ok;
+}
+
+// What a client knows about a session; the server keeps one per client as the delta baseline
+struct SessionSnapshot {
+    uint32_t mazeVersion = 0;
+    Vector2i player = { -1, -1 };
+    Vector2i food = { -1, -1 };
+    Vector2i exit = { -1, -1 };
+    bool exitActive = false;
+    int score = -1;
+    int level = -1;
+    int timerTenths = -1;
+    vector<Vector2i> enemies;
+};
+
+bool SameCell(Vector2i a, Vector2i b) { return a.x == b.x && a.y == b.y; }
+
+struct ClientConnection;
+
+// Authoritative state of one hosted game: the same rules as the windowed game,
+// minus rendering, audio and the exit puzzle (reaching the exit advances the level)
+class GameSession {
+public:
+    uint32_t id;
+    bool persistent;  // hosted until shutdown (bot / pre-created sessions)
+    bool bot;         // inputs come from a built-in random walker
+    vector<vector<int>> maze;
+    uint32_t mazeVersion = 0;
+    vector<uint8_t> inputs;               // queued by the network thread between ticks
+    vector<ClientConnection*> viewers;
+
+    GameSession(uint32_t id, uint32_t seed, bool persistent, bool bot)
+        : id(id), persistent(persistent), bot(bot), rng(seed) {
+        enemies.push_back(EnemyPatrol({ {3, 3}, {5, 3}, {5, 5}, {3, 5} }));
+        enemies.push_back(EnemyPatrol({ {7, 7}, {7, 9}, {9, 9}, {9, 7} }));
+        Restart();
+    }
+
+    void Restart() {
+        score = 0;
+        level = 1;
+        nextLevelScore = 100;
+        timer = 60.0f;
+        StartLevel();
+    }
+
+    void Tick(float deltaTime) {
+        tick++;
+        if (bot && tick % 4 == 0) {
+            inputs.push_back(timer > 0 ? static_cast<uint8_t>(rng() % 4) : ACTION_RESTART);
+        }
+        for (uint8_t action : inputs) {
+            if (action == ACTION_RESTART && timer <= 0) Restart();
+            else if (action < directions.size() && timer > 0) MovePlayer(directions[action]);
+        }
+        inputs.clear();
+        if (timer <= 0) return;
+
+        timer = max(0.0f, timer - deltaTime);
+        timeSinceLastHit += deltaTime;
+        for (auto& enemy : enemies) {
+            enemy.Update(deltaTime);
+        }
+
+        if (SameCell(player, food)) {
+            food = RandomOpenCell();
+            score += 50;
+        }
+        if (score >= nextLevelScore && !exitActive) {
+            exit = RandomOpenCell();
+            exitActive = true;
+        }
+        if (exitActive && SameCell(player, exit)) {
+            level++;
+            nextLevelScore += 150;
+            timer = 60.0f - (level - 1) * 5;
+            StartLevel();
+        }
+        for (const auto& enemy : enemies) {
+            if (SameCell(player, enemy.position) && timeSinceLastHit >= 1.0f) {
+                score = max(0, score - 1);
+                timeSinceLastHit = 0.0f;
+            }
+        }
+    }
+
+    uint32_t TickCount() const { return tick; }
+
+    SessionSnapshot Snapshot() const {
+        SessionSnapshot snapshot;
+        snapshot.mazeVersion = mazeVersion;
+        snapshot.player = player;
+        snapshot.food = food;
+        snapshot.exit = exit;
+        snapshot.exitActive = exitActive;
+        snapshot.score = score;
+        snapshot.level = level;
+        snapshot.timerTenths = static_cast<int>(timer * 10);
+        for (const auto& enemy : enemies) snapshot.enemies.push_back(enemy.position);
+        return snapshot;
+    }
+
+private:
+    mt19937 rng;
+    uint32_t tick = 0;
+    Vector2i player = { 1, 1 };
+    Vector2i food = { 1, 1 };
+    Vector2i exit = { -1, -1 };
+    bool exitActive = false;
+    int score = 0;
+    int level = 1;
+    int nextLevelScore = 100;
+    float timer = 60.0f;
+    float timeSinceLastHit = 0.0f;
+    vector<EnemyPatrol> enemies;
+
+    void StartLevel() {
+        maze = GenerateMaze(mazeWidth, mazeHeight, rng());
+        mazeVersion++;
+        player = { 1, 1 };
+        food = RandomOpenCell();
+        exit = { -1, -1 };
+        exitActive = false;
+        for (auto& enemy : enemies) {
+            enemy.moveDelay = max(0.2f, 0.5f - level * 0.05f);
+            enemy.moveTimer = 0.0f;
+            enemy.patrolIndex = 0;
+            enemy.position = enemy.patrolPath[0];
+        }
+    }
+
+    void MovePlayer(Vector2i direction) {
+        Vector2i next = { player.x + direction.x, player.y + direction.y };
+        int width = maze[0].size();
+        int height = maze.size();
+        if (next.x >= 0 && next.x < width && next.y >= 0 && next.y < height &&
+            maze[next.y][next.x] == 0) {
+            player = next;
+        }
+    }
+
+    Vector2i RandomOpenCell() {
+        Vector2i cell;
+        do {
+            cell = { static_cast<int>(rng() % maze[0].size()), static_cast<int>(rng() % maze.size()) };
+        } while (maze[cell.y][cell.x] != 0);
+        return cell;
+    }
+};
+
+// Append a snapshot holding only the fields that changed since the baseline, then advance the baseline
+void EncodeSnapshotDelta(const GameSession& session, SessionSnapshot& baseline, vector<uint8_t>& out) {
+    SessionSnapshot current = session.Snapshot();
+    uint16_t mask = 0;
+    if (current.mazeVersion != baseline.mazeVersion) mask |= SNAP_MAZE;
+    if (!SameCell(current.player, baseline.player)) mask |= SNAP_PLAYER;
+    if (!SameCell(current.food, baseline.food)) mask |= SNAP_FOOD;
+    if (current.exitActive != baseline.exitActive || !SameCell(current.exit, baseline.exit)) mask |= SNAP_EXIT;
+    if (current.score != baseline.score) mask |= SNAP_SCORE;
+    if (current.level != baseline.level) mask |= SNAP_LEVEL;
+    if (current.timerTenths != baseline.timerTenths) mask |= SNAP_TIMER;
+    bool enemiesChanged = current.enemies.size() != baseline.enemies.size();
+    for (size_t i = 0; !enemiesChanged && i < current.enemies.size(); i++) {
+        enemiesChanged = !SameCell(current.enemies[i], baseline.enemies[i]);
+    }
+    if (enemiesChanged) mask |= SNAP_ENEMIES;
+    if (mask == 0) return;
+
+    size_t start = BeginMessage(out, MSG_SNAPSHOT);
+    PutU32(out, session.TickCount());
+    PutU16(out, mask);
+    if (mask & SNAP_MAZE) {
+        PutU16(out, session.maze[0].size());
+        PutU16(out, session.maze.size());
+        PackMaze(session.maze, out);
+    }
+    if (mask & SNAP_PLAYER) {
+        PutU16(out, current.player.x);
+        PutU16(out, current.player.y);
+    }
+    if (mask & SNAP_FOOD) {
+        PutU16(out, current.food.x);
+        PutU16(out, current.food.y);
+    }
+    if (mask & SNAP_EXIT) {
+        PutU8(out, current.exitActive);
+        PutU16(out, current.exit.x);
+        PutU16(out, current.exit.y);
+    }
+    if (mask & SNAP_SCORE) PutU32(out, current.score);
+    if (mask & SNAP_LEVEL) PutU16(out, current.level);
+    if (mask & SNAP_TIMER) PutU16(out, current.timerTenths);
+    if (mask & SNAP_ENEMIES) {
+        PutU8(out, current.enemies.size());
+        for (const auto& enemy : current.enemies) {
+            PutU16(out, enemy.x);
+            PutU16(out, enemy.y);
+        }
+    }
+    EndMessage(out, start);
+    baseline = current;
+}
+
+// Apply a snapshot message (after the type byte) on top of the client's view
+bool DecodeSnapshot(ByteReader& reader, SessionSnapshot& view, vector<vector<int>>& maze) {
+    reader.U32(); // tick
+    uint16_t mask = reader.U16();
+    if (mask & SNAP_MAZE) {
+        int width = reader.U16();
+        int height = reader.U16();
+        if (!reader.ok || width == 0 || height == 0) return false;
+        size_t cells = static_cast<size_t>(width) * height;
+        size_t bytes = (cells + 7) / 8;
+        if (reader.position + bytes > reader.size) return false;
+        maze.assign(height, vector<int>(width, 1));
+        for (size_t bit = 0; bit < cells; bit++) {
+            maze[bit / width][bit % width] = (reader.data[reader.position + bit / 8] >> (bit % 8)) & 1;
+        }
+        reader.position += bytes;
+        view.mazeVersion++;
+    }
+    if (mask & SNAP_PLAYER) view.player = { reader.U16(), reader.U16() };
+    if (mask & SNAP_FOOD) view.food = { reader.U16(), reader.U16() };
+    if (mask & SNAP_EXIT) {
+        view.exitActive = reader.U8() != 0;
+        view.exit = { reader.U16(), reader.U16() };
+    }
+    if (mask & SNAP_SCORE) view.score = static_cast<int32_t>(reader.U32());
+    if (mask & SNAP_LEVEL) view.level = reader.U16();
+    if (mask & SNAP_TIMER) view.timerTenths = reader.U16();
+    if (mask & SNAP_ENEMIES) {
+        view.enemies.resize(reader.U8());
+        for (auto& enemy : view.enemies) enemy = { reader.U16(), reader.U16() };
+    }
+    return reader.ok;
+}
+
+// One connected client on the server side
+struct ClientConnection {
+    SocketHandle socket;
+    vector<uint8_t> received;
+    vector<uint8_t> outgoing;
+    GameSession* session = nullptr;
+    SessionSnapshot baseline;
+    bool closed = false;
+};
+
+// Server settings (see PrintServerUsage)
+struct ServerSettings {
+    int port = defaultServerPort;
+    int tickRate = 30;
+    unsigned threads = thread::hardware_concurrency();
+    int sessions = 0;
+    int bots = 0;
+    uint64_t ticks = 0; // 0 = run until killed
+};
+
+void PrintServerUsage() {
+    std::cerr << "Usage: myMaze --server [options]\n"
+        << "  --port N       local TCP port (default " << defaultServerPort << ")\n"
+        << "  --tick-rate N  simulation ticks per second (default 30)\n"
+        << "  --threads N    worker threads (default: all cores)\n"
+        << "  --sessions N   idle sessions to host from the start\n"
+        << "  --bots N       sessions driven by built-in bots\n"
+        << "  --ticks N      stop after N ticks (default: run until killed)\n";
+}
+
+bool ParseServerSettings(int argc, char* argv[], ServerSettings& settings) {
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help") return false;
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        try {
+            if (arg == "--port") {
+                if (!ParsePort(value, settings.port)) return false;
+            }
+            else if (arg == "--tick-rate") settings.tickRate = std::stoi(value);
+            else if (arg == "--threads") {
+                if (!ParseThreadCount(value, settings.threads)) return false;
+            }
+            else if (arg == "--sessions") settings.sessions = std::stoi(value);
+            else if (arg == "--bots") settings.bots = std::stoi(value);
+            else if (arg == "--ticks") settings.ticks = std::stoull(value);
+            else {
+                std::cerr << "Unknown option " << arg << "\n";
+                return false;
+            }
+        }
+        catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+            return false;
+        }
+    }
+    if (settings.tickRate <= 0) {
+        std::cerr << "Tick rate must be positive.\n";
+        return false;
     }
+    return true;
+}
 
-    void Move(Vector2 direction, const vector<vector<int>>& maze) {
-        Vector2 nextPosition = { position.x + direction.x, position.y + direction.y };
+// Headless server: hosts many independent sessions, ticks them at a fixed
+// rate on a work-stealing pool and streams delta snapshots to local clients
+class SessionServer {
+public:
+    explicit SessionServer(const ServerSettings& settings)
+        : settings(settings), pool(settings.threads), seeds(static_cast<uint32_t>(time(nullptr))) {}
 
-        // Check if the next position is a valid path (not a wall)
-        if (nextPosition.x >= 0 && nextPosition.x < maze[0].size() &&
-            nextPosition.y >= 0 && nextPosition.y < maze.size() &&
-            maze[static_cast<int>(nextPosition.y)][static_cast<int>(nextPosition.x)] == 0) {
-            position = nextPosition;
+    ~SessionServer() {
+        for (auto& client : clients) CloseSocket(client->socket);
+        if (listener != INVALID_SOCKET) CloseSocket(listener);
+    }
+
+    bool Listen() {
+        listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (listener == INVALID_SOCKET) return false;
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // local clients only
+        address.sin_port = htons(settings.port);
+        if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listener, SOMAXCONN) != 0 || !SetNonBlocking(listener)) {
+            std::cerr << "Failed to listen on port " << settings.port << ".\n";
+            return false;
         }
+        return true;
     }
-};
 
+    void Run() {
+        for (int i = 0; i < settings.sessions; i++) CreateSession(true, false);
+        for (int i = 0; i < settings.bots; i++) CreateSession(true, true);
+        std::cout << "Serving " << sessions.size() << " sessions on 127.0.0.1:" << settings.port << " at "
+            << settings.tickRate << " ticks/s with " << pool.Size() << " threads\n";
+
+        typedef std::chrono::steady_clock Clock;
+        const Clock::duration tickPeriod = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / settings.tickRate));
+        Clock::time_point nextTick = Clock::now();
+        Clock::time_point nextReport = nextTick + std::chrono::seconds(5);
+        double busySeconds = 0.0;
+        uint64_t ticksSinceReport = 0;
+
+        while (settings.ticks == 0 || tickCount < settings.ticks) {
+            Clock::time_point now = Clock::now();
+            int timeoutMs = 0;
+            if (now < nextTick) {
+                timeoutMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(nextTick - now).count());
+            }
+            PollNetwork(timeoutMs);
+            if (Clock::now() < nextTick) continue;
+
+            Clock::time_point tickStart = Clock::now();
+            Tick(1.0f / settings.tickRate);
+            FlushClients();
+            busySeconds += std::chrono::duration<double>(Clock::now() - tickStart).count();
+            ticksSinceReport++;
+
+            // Fixed rate: schedule from the previous deadline, but drop ticks we are too far behind on
+            nextTick += tickPeriod;
+            if (Clock::now() - nextTick > tickPeriod * 5) {
+                nextTick = Clock::now() + tickPeriod;
+            }
+            if (Clock::now() >= nextReport) {
+                std::cout << sessions.size() << " sessions, " << clients.size() << " clients, "
+                    << (busySeconds * 1000.0 / ticksSinceReport) << " ms per tick\n";
+                busySeconds = 0.0;
+                ticksSinceReport = 0;
+                nextReport += std::chrono::seconds(5);
+            }
+        }
+        std::cout << "Stopped after " << tickCount << " ticks\n";
+    }
 
-// Enemy class
-class Enemy {
-public:
-    Texture2D image;
-    Vector2i position;
-    vector<Vector2i> patrolPath;
-    int patrolIndex = 0;
-    float moveTimer = 0.0f; // Timer for movement
-    float moveDelay = 0.5f; // Delay between movements in seconds
+private:
+    ServerSettings settings;
+    WorkStealingPool pool;
+    mt19937 seeds;
+    SocketHandle listener = INVALID_SOCKET;
+    vector<unique_ptr<GameSession>> sessions;
+    vector<unique_ptr<ClientConnection>> clients;
+    vector<PollDescriptor> descriptors;
+    uint32_t nextSessionId = 1;
+    uint64_t tickCount = 0;
+
+    GameSession* CreateSession(bool persistent, bool bot) {
+        sessions.emplace_back(new GameSession(nextSessionId++, seeds(), persistent, bot));
+        return sessions.back().get();
+    }
 
-    Enemy(Texture2D& texture, const vector<Vector2i>& path) {
-        image = texture;
-        patrolPath = path;
-        position = patrolPath[0];
+    GameSession* FindSession(uint32_t id) {
+        for (auto& session : sessions) {
+            if (session->id == id) return session.get();
+        }
+        return nullptr;
     }
 
-    void Draw(Vector2 offset) const {
-        DrawTextureV(image, { offset.x + position.x * gridSize, offset.y + position.y * gridSize }, WHITE);
+    // Advance every session one tick; sessions are independent, so they are
+    // ticked (and their snapshots encoded) in parallel batches
+    void Tick(float deltaTime) {
+        const size_t batchSize = 64;
+        for (size_t first = 0; first < sessions.size(); first += batchSize) {
+            size_t last = min(sessions.size(), first + batchSize);
+            pool.Submit([this, first, last, deltaTime] {
+                for (size_t i = first; i < last; i++) {
+                    GameSession& session = *sessions[i];
+                    session.Tick(deltaTime);
+                    for (ClientConnection* viewer : session.viewers) {
+                        // A client that is not draining its socket skips snapshots; the next
+                        // delta is taken against what it last received, so nothing is lost
+                        if (viewer->outgoing.size() < 64 * 1024) {
+                            EncodeSnapshotDelta(session, viewer->baseline, viewer->outgoing);
+                        }
+                    }
+                }
+            });
+        }
+        pool.WaitIdle();
+        tickCount++;
     }
 
-    void Update(float deltaTime) {
-        moveTimer += deltaTime;
-        if (moveTimer >= moveDelay) {
-            patrolIndex = (patrolIndex + 1) % patrolPath.size();
-            position = patrolPath[patrolIndex];
-            moveTimer = 0.0f; // Reset timer
+    void PollNetwork(int timeoutMs) {
+        descriptors.resize(clients.size() + 1);
+        descriptors[0].fd = listener;
+        descriptors[0].events = POLLIN;
+        descriptors[0].revents = 0;
+        for (size_t i = 0; i < clients.size(); i++) {
+            descriptors[i + 1].fd = clients[i]->socket;
+            descriptors[i + 1].events = POLLIN;
+            descriptors[i + 1].revents = 0;
+        }
+        if (PollSockets(descriptors.data(), descriptors.size(), timeoutMs) <= 0) return;
+
+        if (descriptors[0].revents & POLLIN) AcceptClients();
+        for (size_t i = 0; i < clients.size() && i + 1 < descriptors.size(); i++) {
+            if (descriptors[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) ReceiveFrom(*clients[i]);
         }
+        RemoveClosedClients();
     }
-};
 
+    void AcceptClients() {
+        while (true) {
+            SocketHandle socket = accept(listener, nullptr, nullptr);
+            if (socket == INVALID_SOCKET) return;
+            int noDelay = 1;
+            setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+            if (!SetNonBlocking(socket)) {
+                CloseSocket(socket);
+                continue;
+            }
+            clients.emplace_back(new ClientConnection());
+            clients.back()->socket = socket;
+        }
+    }
 
-// food class
-class Food {
-public:
-    Vector2i position;
-    Texture2D texture;
+    void ReceiveFrom(ClientConnection& client) {
+        uint8_t buffer[4096];
+        while (true) {
+            int received = recv(client.socket, reinterpret_cast<char*>(buffer), sizeof(buffer), 0);
+            if (received > 0) {
+                client.received.insert(client.received.end(), buffer, buffer + received);
+                continue;
+            }
+            if (received < 0 && SocketWouldBlock()) break;
+            client.closed = true; // orderly shutdown or error
+            return;
+        }
 
-    // Food image
-    Food(Texture2D& texture, const vector<vector<int>>& maze) : texture(texture)
-    {
-        position = GenerateRandomPos(maze);
+        vector<uint8_t> message;
+        bool protocolError = false;
+        while (PopMessage(client.received, message, protocolError)) {
+            ByteReader reader(message.data(), message.size());
+            uint8_t type = reader.U8();
+            if (type == MSG_JOIN && client.session == nullptr) {
+                uint32_t id = reader.U32();
+                if (!reader.ok) {
+                    protocolError = true;
+                }
+                else {
+                    GameSession* session = (id == NEW_SESSION) ? nullptr : FindSession(id);
+                    if (session == nullptr) session = CreateSession(false, false);
+                    client.session = session;
+                    session->viewers.push_back(&client);
+                    size_t start = BeginMessage(client.outgoing, MSG_WELCOME);
+                    PutU32(client.outgoing, session->id);
+                    EndMessage(client.outgoing, start);
+                }
+            }
+            else if (type == MSG_INPUT && client.session != nullptr) {
+                uint8_t action = reader.U8();
+                if (reader.ok && client.session->inputs.size() < 16) client.session->inputs.push_back(action);
+            }
+            else {
+                protocolError = true;
+            }
+            if (protocolError) break;
+        }
+        if (protocolError) client.closed = true;
     }
 
-    void Draw(Vector2 offset) {
-        DrawTexture(texture, offset.x + position.x * gridSize, offset.y + position.y * gridSize, WHITE);
+    void FlushClients() {
+        for (auto& client : clients) {
+            if (!FlushOutgoing(client->socket, client->outgoing)) client->closed = true;
+        }
+        RemoveClosedClients();
     }
 
-    // Generate random food position
-    Vector2i GenerateRandomPos(const vector<vector<int>>& maze)
-    {
-        Vector2i newPos;
-        do {
-            // Generate a random position within the maze's boundaries
-            newPos = { GetRandomValue(0, maze[0].size() - 1), GetRandomValue(0, maze.size() - 1) };
-        } while (maze[newPos.y][newPos.x] != 0);  // Ensure food spawns on a valid path
-        return newPos;
+    void RemoveClosedClients() {
+        for (size_t i = 0; i < clients.size();) {
+            ClientConnection* client = clients[i].get();
+            if (!client->closed) {
+                i++;
+                continue;
+            }
+            if (client->session != nullptr) {
+                auto& viewers = client->session->viewers;
+                viewers.erase(std::remove(viewers.begin(), viewers.end(), client), viewers.end());
+            }
+            CloseSocket(client->socket);
+            clients.erase(clients.begin() + i);
+        }
+        // Sessions created for clients end when their last client leaves
+        sessions.erase(std::remove_if(sessions.begin(), sessions.end(), [](const unique_ptr<GameSession>& session) {
+            return !session->persistent && session->viewers.empty();
+        }), sessions.end());
     }
 };
 
-// Sounds
-Sound Foodsound;
-Sound GOsound;
-Sound Nextlevel;
-Sound powerupsd;
-Music backgsound;
+int RunServer(int argc, char* argv[]) {
+    ServerSettings settings;
+    if (!ParseServerSettings(argc, argv, settings)) {
+        PrintServerUsage();
+        return 1;
+    }
+    if (!InitNetwork()) {
+        std::cerr << "Failed to initialise networking.\n";
+        return 1;
+    }
+    int result = 0;
+    {
+        SessionServer server(settings);
+        if (server.Listen()) server.Run();
+        else result = 1;
+    }
+    ShutdownNetwork();
+    return result;
+}
 
-void InitSounds() {
-    InitAudioDevice();
+// Thin client settings (see PrintClientUsage)
+struct ClientSettings {
+    int port = defaultServerPort;
+    uint32_t sessionId = NEW_SESSION;
+};
 
-    Foodsound = LoadSound("sounds/foodsound.wav");
-    GOsound = LoadSound("sounds/gosound.wav");
-    Nextlevel = LoadSound("sounds/nextlevel.wav");
-    powerupsd = LoadSound("sounds/powerUpsound.wav");
+void PrintClientUsage() {
+    std::cerr << "Usage: myMaze --connect [options]\n"
+        << "  --port N       server port on 127.0.0.1 (default " << defaultServerPort << ")\n"
+        << "  --session ID   join an existing session (default: start a new one)\n";
+}
 
-    backgsound = LoadMusicStream("sounds/backgroundsound.mp3");
-    PlayMusicStream(backgsound);
+bool ParseClientSettings(int argc, char* argv[], ClientSettings& settings) {
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help") return false;
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        try {
+            if (arg == "--port") {
+                if (!ParsePort(value, settings.port)) return false;
+            }
+            else if (arg == "--session") {
+                unsigned long id = std::stoul(value);
+                if (id >= NEW_SESSION) {
+                    std::cerr << "Invalid session id " << value << "\n";
+                    return false;
+                }
+                settings.sessionId = static_cast<uint32_t>(id);
+            }
+            else {
+                std::cerr << "Unknown option " << arg << "\n";
+                return false;
+            }
+        }
+        catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+            return false;
+        }
+    }
+    return true;
 }
 
-// Function to solve the puzzle in-game
-bool SolvePuzzle(int& remainingAttempts) {
-    srand(static_cast<unsigned>(time(0)));
-    int a = rand() % 10 + 1;
-    int b = rand() % 10 + 1;
-    int correctAnswer = a + b;
+// Thin client: the raylib front end drawing a session hosted by --server
+int RunClient(int argc, char* argv[]) {
+    ClientSettings settings;
+    if (!ParseClientSettings(argc, argv, settings)) {
+        PrintClientUsage();
+        return 1;
+    }
+    int port = settings.port;
+    uint32_t sessionId = settings.sessionId;
+    if (!InitNetwork()) {
+        std::cerr << "Failed to initialise networking.\n";
+        return 1;
+    }
 
-    std::string input = "";
-    bool solved = false;
-    bool running = true;
+    SocketHandle server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (server == INVALID_SOCKET || connect(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Could not connect to a server on port " << port << ".\n";
+        if (server != INVALID_SOCKET) CloseSocket(server);
+        ShutdownNetwork();
+        return 1;
+    }
+    int noDelay = 1;
+    setsockopt(server, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
 
-    while (running) {
-        BeginDrawing();
-        ClearBackground(BLACK);
+    SetNonBlocking(server);
 
-        // Draw puzzle text
-        DrawText(("Solve: " + std::to_string(a) + " + " + std::to_string(b)).c_str(), 50, 50, 20, WHITE);
-        DrawText(("Your Answer: " + input).c_str(), 50, 100, 20, WHITE);
-        DrawText(("Attempts Left: " + std::to_string(remainingAttempts)).c_str(), 50, 150, 20, RED);
+    // Messages to the server; whatever the socket does not take is kept for the next frame
+    vector<uint8_t> outgoing;
+    size_t start = BeginMessage(outgoing, MSG_JOIN);
+    PutU32(outgoing, sessionId);
+    EndMessage(outgoing, start);
 
-        // Debugging output
-        TraceLog(LOG_INFO, "Attempts: %d, Input: %s, Solved: %d, Running: %d",
-            remainingAttempts, input.c_str(), solved, running);
+    InitWindow(screenWidth, screenHeight, "Mystery Maze (client)");
+    SetTargetFPS(60);
+    Texture2D playerTexture = LoadTexture("pics/player1.png");
+    Texture2D foodTexture = LoadTexture("pics/tile.png");
+    Texture2D enemyTexture = LoadTexture("pics/enemy.png");
 
-        // Handle keyboard input
-        if (IsKeyPressed(KEY_ENTER)) {
-            if (!input.empty() && std::all_of(input.begin(), input.end(), ::isdigit)) {
-                int playerAnswer = std::stoi(input);
-                if (playerAnswer == correctAnswer) {
-                    solved = true;
-                    running = false;
-                }
-                else {
-                    remainingAttempts--;
-                    if (remainingAttempts > 0) {
-                        input = "Try Again!";
-                    }
-                    else {
-                        running = false; // Out of attempts
-                    }
-                }
-            }
-            else {
-                input = "Invalid Input!";
+    vector<uint8_t> received;
+    vector<uint8_t> message;
+    SessionSnapshot view;
+    vector<vector<int>> maze;
+    bool connected = true;
+    const int keys[] = { KEY_W, KEY_D, KEY_S, KEY_A }; // same order as directions
+
+    while (!WindowShouldClose() && connected) {
+        uint8_t buffer[4096];
+        while (true) {
+            int count = recv(server, reinterpret_cast<char*>(buffer), sizeof(buffer), 0);
+            if (count > 0) {
+                received.insert(received.end(), buffer, buffer + count);
+                continue;
             }
+            if (count == 0 || !SocketWouldBlock()) connected = false;
+            break;
         }
-        else if (IsKeyPressed(KEY_BACKSPACE) && !input.empty()) {
-            input.pop_back();
+        bool protocolError = false;
+        while (PopMessage(received, message, protocolError)) {
+            ByteReader reader(message.data(), message.size());
+            uint8_t type = reader.U8();
+            if (type == MSG_WELCOME) sessionId = reader.U32();
+            else if (type == MSG_SNAPSHOT && !DecodeSnapshot(reader, view, maze)) protocolError = true;
+            if (protocolError) break;
         }
-        else {
-            // Check for numeric input
-            for (int key = KEY_ZERO; key <= KEY_NINE; ++key) {
-                if (IsKeyPressed(key)) {
-                    input += (key - KEY_ZERO) + '0';
-                }
+        if (protocolError) connected = false;
+
+        for (int i = 0; i < 4; i++) {
+            if (IsKeyPressed(keys[i])) {
+                start = BeginMessage(outgoing, MSG_INPUT);
+                PutU8(outgoing, i);
+                EndMessage(outgoing, start);
             }
         }
+        if (IsKeyPressed(KEY_ENTER)) {
+            start = BeginMessage(outgoing, MSG_INPUT);
+            PutU8(outgoing, ACTION_RESTART);
+            EndMessage(outgoing, start);
+        }
+        if (!FlushOutgoing(server, outgoing)) connected = false;
 
-        // Draw feedback if incorrect
-        if (!solved && input == "Try Again!") {
-            DrawText("Incorrect. Try again!", 50, 200, 20, RED);
+        BeginDrawing();
+        ClearBackground(BLACK);
+        if (!maze.empty()) {
+            Vector2 offset = {
+                (screenWidth - static_cast<int>(maze[0].size()) * gridSize) / 2.0f,
+                (screenHeight - static_cast<int>(maze.size()) * gridSize) / 2.0f
+            };
+            DrawMaze(maze, offset);
+            DrawTexture(foodTexture, offset.x + view.food.x * gridSize, offset.y + view.food.y * gridSize, WHITE);
+            DrawTextureV(playerTexture, { offset.x + view.player.x * gridSize, offset.y + view.player.y * gridSize }, WHITE);
+            for (const auto& enemy : view.enemies) {
+                DrawTextureV(enemyTexture, { offset.x + enemy.x * gridSize, offset.y + enemy.y * gridSize }, WHITE);
+            }
+            if (view.exitActive) {
+                DrawRectangleV({ offset.x + view.exit.x * gridSize, offset.y + view.exit.y * gridSize },
+                    { gridSize, gridSize }, GREEN);
+            }
+            DrawText(TextFormat("Score: %d", view.score), 10, 10, 20, WHITE);
+            DrawText(TextFormat("Time Left: %.1f", view.timerTenths / 10.0f), screenWidth - 150, 10, 20, WHITE);
+            DrawText(TextFormat("Level: %d", view.level), 10, 70, 20, WHITE);
+            DrawText(TextFormat("Session %u", sessionId), 10, screenHeight - 30, 20, DARKGRAY);
+            if (view.timerTenths == 0) {
+                DrawText("GAME OVER! Press ENTER to restart",
+                    screenWidth / 2 - MeasureText("GAME OVER! Press ENTER to restart", 30) / 2,
+                    screenHeight / 2 - 15, 30, RED);
+            }
         }
-        else if (!solved && input == "Invalid Input!") {
-            DrawText("Please enter a valid number!", 50, 200, 20, RED);
+        else {
+            DrawText("Waiting for server...", screenWidth / 2 - MeasureText("Waiting for server...", 30) / 2,
+                screenHeight / 2 - 15, 30, WHITE);
         }
-
         EndDrawing();
+    }
 
-        // Exit if no attempts left
-        if (remainingAttempts <= 0) {
-            break;
+    UnloadTexture(playerTexture);
+    UnloadTexture(foodTexture);
+    UnloadTexture(enemyTexture);
+    CloseWindow();
+    CloseSocket(server);
+    ShutdownNetwork();
+    if (!connected) std::cerr << "Disconnected from server.\n";
+    return 0;
+}
+
+
+// Frame pacing settings (game options --fps N, --idle-fps N, --vsync)
+struct FrameSettings {
+    int targetFps = 60; // cap for drawn frames
+    int idleFps = 30;   // input/music polling rate on static screens, fast enough to keep music streaming
+    bool vsync = false;
+};
+
+bool ParseFrameSettings(int argc, char* argv[], FrameSettings& settings) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--vsync") {
+            settings.vsync = true;
+        }
+        else if ((arg == "--fps" || arg == "--idle-fps") && i + 1 < argc) {
+            const char* value = argv[++i];
+            try {
+                size_t used = 0;
+                int fps = std::stoi(value, &used);
+                if (value[used] != '\0' || fps <= 0) throw std::invalid_argument(arg);
+                (arg == "--fps" ? settings.targetFps : settings.idleFps) = fps;
+            }
+            catch (const std::exception&) {
+                std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+                return false;
+            }
+        }
+        else {
+            std::cerr << "Usage: myMaze [--fps N] [--idle-fps N] [--vsync]\n"
+                << "       myMaze --batch | --server | --connect [options]\n";
+            return false;
         }
     }
-
-    TraceLog(LOG_INFO, "Final Solved: %d, Remaining Attempts: %d", solved, remainingAttempts);
-    return solved;
+    return true;
 }
 
-// Exit Struct
-class Exit {
+// Frame pacing: caps the frame rate and skips redrawing static screens
+// (menu, pause, game over) until input or a screen change makes them stale
+class FramePacer {
 public:
-    Vector2 position; // Grid position (floating-point for flexibility)
-    bool active;
+    explicit FramePacer(const FrameSettings& settings) : settings(settings) {}
 
-    Exit() : position({ -1.0f, -1.0f }), active(false) {}
-
-    void Activate(const vector<vector<int>>& maze) {
-        position = GenerateRandomPos(maze);
-        active = true;
+    // Call before InitWindow: vsync is a window creation hint
+    void ConfigureWindow() const {
+        if (settings.vsync) SetConfigFlags(FLAG_VSYNC_HINT);
     }
 
-    void Deactivate() {
-        position = { -1.0f, -1.0f }; // Move to an invalid position
-        active = false;
+    // Call after InitWindow
+    void Start() {
+        SetTargetFPS(settings.targetFps);
+        lastFrame = GetTime();
     }
 
-    void Draw(Vector2 offset) {
-        if (active) {
-            DrawRectangleV({ offset.x + position.x * gridSize, offset.y + position.y * gridSize },
-                { gridSize, gridSize }, GREEN);
+    // Animated screens are always drawn; static ones only when something changed
+    bool ShouldRedraw(bool staticScreen, int screen) {
+        double now = GetTime();
+        bool redraw = !staticScreen || screen != lastScreen || HasInput() || IsWindowResized() ||
+            now - lastRedraw >= 1.0; // periodic refresh in case the window contents were lost
+        if (redraw) {
+            lastScreen = screen;
+            lastRedraw = now;
         }
+        return redraw;
+    }
+
+    // Idle frame: nothing is drawn, input is still polled (EndDrawing normally does this)
+    void SkipFrame() {
+        WaitTime(1.0 / settings.idleFps);
+        PollInputEvents();
+        lastFrame = GetTime(); // time spent idle is not game time
+    }
+
+    // Seconds since the previous drawn frame
+    float FrameTime() {
+        double now = GetTime();
+        float elapsed = static_cast<float>(now - lastFrame);
+        lastFrame = now;
+        return elapsed;
     }
 
 private:
-    Vector2 GenerateRandomPos(const vector<vector<int>>& maze) {
-        Vector2 newPos;
-        do {
-            newPos = { static_cast<float>(GetRandomValue(0, maze[0].size() - 1)),
-                       static_cast<float>(GetRandomValue(0, maze.size() - 1)) };
-        } while (maze[static_cast<int>(newPos.y)][static_cast<int>(newPos.x)] != 0); // Ensure it's on a valid path
-        return newPos;
+    FrameSettings settings;
+    double lastFrame = 0.0;
+    double lastRedraw = 0.0;
+    int lastScreen = -1;
+
+    static bool HasInput() {
+        Vector2 mouseDelta = GetMouseDelta();
+        return mouseDelta.x != 0 || mouseDelta.y != 0 || GetMouseWheelMove() != 0 ||
+            IsMouseButtonDown(MOUSE_BUTTON_LEFT) || IsMouseButtonReleased(MOUSE_BUTTON_LEFT) ||
+            GetKeyPressed() != 0;
     }
 };
 
 
+int main(int argc, char* argv[]) {
+    // Headless tools
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        return RunBatch(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--server") {
+        return RunServer(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--connect") {
+        return RunClient(argc, argv);
+    }
+
+    FrameSettings frameSettings;
+    if (!ParseFrameSettings(argc, argv, frameSettings)) {
+        return 1;
+    }
+    FramePacer framePacer(frameSettings);
 
-int main() {
     // Initialize the window
     srand(time(nullptr));
+    framePacer.ConfigureWindow();
     InitWindow(screenWidth, screenHeight, "Menu and Game Screen");
+    framePacer.Start();
     InitSounds();
 
     // Load resources
@@ -405,10 +2514,23 @@ int main() {
     float volume = 0.5f; // Initial volume (50%)
     SetMasterVolume(volume); // Set initial volume
     int attempts = 3; // Maximum attempts for solving the puzzle
+    AudioEvent gameOverSound;
   
     // Initialize maze, player, food, and enemies
     vector<vector<int>> maze = GenerateMaze();
     Food food(foodTexture, maze);
+    Visibility fog;
+    fog.Reset(maze, sightRadius);
+
+    // Progressive level loading: new levels are carved a time-boxed slice per frame
+    MazeGenerator levelGenerator;
+    const double levelLoadBudget = 0.004; // seconds of carving per frame
+    MazeAlgorithm levelAlgorithm = RECURSIVE_BACKTRACKER; // How the current maze was made (saved with it)
+    auto StartLevelLoad = [&]() {
+        lastMazeSeed = rand();
+        levelAlgorithm = RECURSIVE_BACKTRACKER;
+        levelGenerator.Start(mazeWidth, mazeHeight, lastMazeSeed);
+    };
     Player player(playerTexture);
     vector<Enemy> enemies;
     
@@ -425,12 +2547,21 @@ int main() {
 
     while (!WindowShouldClose() && gameRunning) {
 
-        float deltaTime = GetFrameTime();
-        timeSinceLastHit += deltaTime;
         UpdateMusicStream(backgsound);
 
+        // Static screens (menu, pause, game over) are only redrawn when something changes
+        bool gameOver = currentState == GAME && timer <= 0 && levelGenerator.Done();
+        bool staticScreen = currentState == MENU || (currentState == GAME && (isPaused || gameOver));
+        if (!framePacer.ShouldRedraw(staticScreen, currentState * 4 + isPaused * 2 + gameOver)) {
+            framePacer.SkipFrame();
+            continue;
+        }
+
+        float deltaTime = framePacer.FrameTime();
+        timeSinceLastHit += deltaTime;
+
         // Update game timer
-        if (currentState == GAME && !isPaused && timer > 0) {
+        if (currentState == GAME && !isPaused && timer > 0 && levelGenerator.Done()) {
             timer -= deltaTime;
             if (timer <= 0) timer = 0;
         }
@@ -471,8 +2602,7 @@ int main() {
                     timer = 60.0f - (level - 1) * 5; // Reduce time as levels progress
                     score = 0;      // Reset score
                     player.position = { 1, 1 };  // Reset player position
-                    maze = GenerateMaze();
-                    food.position = food.GenerateRandomPos(maze);
+                    StartLevelLoad();
                     
                     // load the super enemy
                     for (auto& enemy : enemies) {
@@ -492,6 +2622,29 @@ int main() {
                     currentLevel = data.currentLevel;
                     score = data.score;
                     playerPosition = data.playerPosition;
+                    vector<vector<int>> savedMaze;
+                    MazeFileHeader savedHeader;
+                    if (LoadMazeFile("savegame.maze", savedMaze, &savedHeader) &&
+                        savedMaze.size() == mazeHeight && savedMaze[0].size() == mazeWidth) {
+                        maze = savedMaze; // Restore the saved level instead of a fresh one
+                        lastMazeSeed = savedHeader.seed;
+                        levelAlgorithm = static_cast<MazeAlgorithm>(savedHeader.algorithm);
+
+                        // Put the player back where they saved, unless that is not a path in this maze
+                        int savedX = static_cast<int>(data.playerPosition.x);
+                        int savedY = static_cast<int>(data.playerPosition.y);
+                        bool onPath = savedX >= 0 && savedX < mazeWidth && savedY >= 0 && savedY < mazeHeight &&
+                            maze[savedY][savedX] == 0;
+                        player.position = onPath ? data.playerPosition : Vector2{ 1, 1 };
+
+                        food.position = food.GenerateRandomPos(maze);
+                        exit.Deactivate();
+                        for (auto& enemy : enemies) {
+                            enemy.patrolIndex = 0;
+                            enemy.position = enemy.patrolPath[0];
+                        }
+                        fog.Reset(maze, sightRadius);
+                    }
                 }
             }
 
@@ -518,6 +2671,22 @@ int main() {
             DrawText(TextFormat("Volume: %d%%", (int)(volume * 100)), volumeSlider.x + 50, volumeSlider.y + 30, 20, BLACK);
 
         }
+        else if (currentState == GAME && !levelGenerator.Done()) {
+            // Loading screen: the new maze appears as it is carved
+            ClearBackground(BLACK);
+            if (levelGenerator.Run(levelLoadBudget)) {
+                maze = levelGenerator.maze;
+                food.position = food.GenerateRandomPos(maze);
+                fog.Reset(maze, sightRadius);
+            }
+            DrawMaze(levelGenerator.maze, offset);
+
+            Rectangle loadingBar = { screenWidth / 2 - 150, screenHeight - 60, 300, 20 };
+            DrawRectangleRec(loadingBar, DARKGRAY);
+            DrawRectangle(loadingBar.x, loadingBar.y, loadingBar.width * levelGenerator.Progress(), loadingBar.height, GREEN);
+            DrawText(TextFormat("Loading level... %d%%", (int)(levelGenerator.Progress() * 100)),
+                loadingBar.x, loadingBar.y - 25, 20, WHITE);
+        }
         else if (currentState == GAME) {
 
             // Game Screen
@@ -557,10 +2726,9 @@ int main() {
                     timer = max(10.0f, 60.0f - level * levelTimeReduction); // Adjust timer
                     nextLevelScore += 150; // Increment score threshold for the next level
                     timer = 60.0f - (level - 1) * 5;
-                    maze = GenerateMaze();
+                    StartLevelLoad();
                     player.position = { 1, 1 };
                     attempts = 3; // Reset attempts for the next puzzle
-                    food.position = food.GenerateRandomPos(maze);
                     
                     PlaySound(Nextlevel);
                     for (auto& enemy : enemies) {
@@ -576,8 +2744,7 @@ int main() {
                     nextLevelScore = 100;           // Reset score for level progression
                     player.position = { 1, 1 };     // Reset player position
                     attempts = 3;
-                    maze = GenerateMaze();          // Generate a new maze
-                    food.position = food.GenerateRandomPos(maze); // Reset food position
+                    StartLevelLoad();               // Generate a new maze
                     
                     for (auto& enemy : enemies) {   // Reset enemy logic
                         enemy.patrolIndex = 0;
@@ -590,9 +2757,8 @@ int main() {
                             timer = max(10.0f, 60.0f - level * levelTimeReduction); // Adjust timer
                             nextLevelScore += 150; // Increment score threshold for the next level
                             timer = 60.0f - (level - 1) * 5;
-                            maze = GenerateMaze();
+                            StartLevelLoad();
                             player.position = { 1, 1 };
-                            food.position = food.GenerateRandomPos(maze);
 
                             PlaySound(Nextlevel);
                             for (auto& enemy : enemies) {
@@ -617,28 +2783,29 @@ int main() {
 
 
             // Draw maze
-            for (int y = 0; y < maze.size(); y++) {
-                for (int x = 0; x < maze[0].size(); x++) {
-                    if (maze[y][x] == 1) {
-                        DrawRectangle(offset.x + x * gridSize, offset.y + y * gridSize, gridSize, gridSize, BLACK);
-                        //DrawRectangleLines(offset.x + x * gridSize, offset.y + y * gridSize, gridSize, gridSize, WHITE);
-                        DrawRectangleLinesEx({ offset.x + x * gridSize, offset.y + y * gridSize, gridSize, gridSize }, 2, RED);
-                        
-                    }
-                }
-            }
+            DrawMaze(maze, offset);
 
             //DrawRectangleLines(50, 50, screenWidth - 100, screenHeight - 100, borderColor);
 
             // Draw Food, Player, Enemy, Super enemy
 
             food.Draw(offset);
+            exit.Draw(offset);
+
+            // Fog of war: reveal around the player, hide enemies outside the player's view
+            Vector2i playerCell = { static_cast<int>(player.position.x), static_cast<int>(player.position.y) };
+            fog.Update(playerCell);
+            DrawFog(fog, offset);
             player.Draw(offset);
           
             for (const auto& enemy : enemies) {
+                if (!fog.visible.Test(enemy.position.x, enemy.position.y)) continue;
                 enemy.Draw(offset);
+                if (fog.HasLineOfSight(enemy.position, playerCell, sightRadius)) {
+                    DrawText("!", offset.x + enemy.position.x * gridSize + gridSize / 2 - 3,
+                        offset.y + enemy.position.y * gridSize - 18, 20, YELLOW); // Enemy has spotted the player
+                }
             }
-            exit.Draw(offset);
            
 
             // Display Score and Timer
@@ -667,8 +2834,11 @@ int main() {
 
             // Save Progress
             if (IsKeyPressed(KEY_U)) {
-                GameData saveData = { currentLevel, score, playerPosition };
+                GameData saveData = { currentLevel, score, player.position };
                 SaveGame(saveData);
+                if (!SaveMazeFile(maze, lastMazeSeed, levelAlgorithm, "savegame.maze")) {
+                    std::cerr << "Failed to save the maze; loading will start a new maze.\n";
+                }
             }
 
             // Update high score
@@ -682,9 +2852,9 @@ int main() {
             DrawText(TextFormat("High Score: %d", highScore), 350, 10, 20, DARKGRAY);
 
             // Show "GAME OVER" text if the timer reaches 0
+            gameOverSound.Update(timer <= 0, GOsound); // once per game over, not every frame
             if (timer <= 0) {
                 DrawText("GAME OVER!", screenWidth / 2 - MeasureText("GAME OVER!", 40) / 2, screenHeight / 2 - 100, 40, RED);
-                PlaySound(GOsound);
 
                 // Display M to return to the menu text
                 DrawText("Press M to return to the menu",
@@ -707,8 +2877,7 @@ int main() {
                     level = 1;
                     nextLevelScore = 100;           // Reset score for level progression
                     player.position = { 1, 1 };     // Reset player position
-                    maze = GenerateMaze();          // Generate a new maze
-                    food.position = food.GenerateRandomPos(maze); // Reset food position
+                    StartLevelLoad();               // Generate a new maze
 
                     for (auto& enemy : enemies) {   // Reset enemy logic
                         enemy.patrolIndex = 0;
@@ -721,10 +2890,9 @@ int main() {
                             timer = max(10.0f, 60.0f - level * levelTimeReduction); // Adjust timer
                             nextLevelScore += 150; // Increment score threshold for the next level
                             timer = 60.0f - (level - 1) * 5;
-                            maze = GenerateMaze();
+                            StartLevelLoad();
                             player.position = { 1, 1 };
                             attempts = 3;
-                            food.position = food.GenerateRandomPos(maze);
                             PlaySound(Nextlevel);
                             for (auto& enemy : enemies) {
                                 enemy.patrolIndex = 0;
@@ -739,8 +2907,7 @@ int main() {
                             nextLevelScore = 100;           // Reset score for level progression
                             player.position = { 1, 1 };     // Reset player position
                             attempts = 3;
-                            maze = GenerateMaze();          // Generate a new maze
-                            food.position = food.GenerateRandomPos(maze); // Reset food position
+                            StartLevelLoad();               // Generate a new maze
                             for (auto& enemy : enemies) {   // Reset enemy logic
                                 enemy.patrolIndex = 0;
                                 enemy.position = enemy.patrolPath[0];
@@ -752,9 +2919,8 @@ int main() {
                                     timer = max(10.0f, 60.0f - level * levelTimeReduction); // Adjust timer
                                     nextLevelScore += 150; // Increment score threshold for the next level
                                     timer = 60.0f - (level - 1) * 5;
-                                    maze = GenerateMaze();
+                                    StartLevelLoad();
                                     player.position = { 1, 1 };
-                                    food.position = food.GenerateRandomPos(maze);
                                     PlaySound(Nextlevel);
                                     for (auto& enemy : enemies) {
                                         enemy.patrolIndex = 0;